@@ -7,8 +7,10 @@
 #include <fstream>
 #include <iostream>
 
+#include "infra/parsers/parser_from_session.hpp"
 #include "infra/serializers/serializer_to_plantuml.hpp"
 #include "infra/serializers/serializer_to_prettyprint.hpp"
+#include "infra/serializers/serializer_to_session.hpp"
 #include "utils/concepts.hpp"
 #include "utils/expected_utils.hpp"
 #include "utils/unreachable.hpp"
@@ -117,6 +119,8 @@ void OpenEMSH::set_output_format(Params::OutputFormat format) {
 //******************************************************************************
 expected<void, string> OpenEMSH::parse() {
 	Caretaker::singleton().reset();
+	Caretaker::singleton().set_keep_history(params.gui || params.history);
+	Caretaker::singleton().set_spill_threshold(params.spill_history);
 	UNWRAP(
 		ParserFromCsx::run(params.input, static_cast<ParserFromCsx::Params const&>(params), params.override_from_cli),
 		[this](auto& value) {
@@ -126,6 +130,35 @@ expected<void, string> OpenEMSH::parse() {
 	return {};
 }
 
+// Replaces the current board and history by the saved ones, the input and the
+// fixed-point mode become the ones of the saved session.
+//******************************************************************************
+expected<void, string> OpenEMSH::open_session(filesystem::path const& path) {
+	Caretaker::singleton().reset();
+	Caretaker::singleton().set_keep_history(params.gui || params.history);
+	Caretaker::singleton().set_spill_threshold(params.spill_history);
+	auto session = ParserFromSession::run(path, [](BinaryReader& in) -> unique_ptr<IAnnotation> {
+		Step step {};
+		in.read(step);
+		return make_unique<Annotation>(step);
+	});
+	if(!session) {
+		Caretaker::singleton().reset();
+		return unexpected(session.error());
+	}
+	board = session->board;
+	params.input = session->input;
+	domain::database_unit = session->database_unit;
+	return {};
+}
+
+//******************************************************************************
+expected<void, string> OpenEMSH::save_session(filesystem::path const& path) const {
+	return SerializerToSession::run(*board, params.input, path, [](IAnnotation const& annotation, BinaryWriter& out) {
+		out.write(static_cast<Annotation const&>(annotation).before_step);
+	});
+}
+
 //******************************************************************************
 bool OpenEMSH::is_about_overwriting() const {
 	return !params.force
@@ -180,7 +213,7 @@ void OpenEMSH::run(std::set<Step> const& steps) const {
 	handle(DETECT_INTERVALS,                [&] { board->detect_intervals(); });
 	handle(DETECT_INTERVALS_PER_DIAG_ZONES, [&] { board->detect_intervals_per_diagonal_zones(); });
 	handle(SOLVE_DIAG_ZONES_INTERVALS,      [&] { board->solve_diagonal_zones_intervals(); });
-	handle(MESH,                            [&] { board->mesh(); });
+	handle(MESH,                            [&] { params.jobs > 1 ? board->mesh_in_parallel(params.jobs) : board->mesh(); });
 
 	Caretaker::singleton().remember_current_timepoint();
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <expected>
 #include <filesystem>
 #include <functional>
@@ -34,6 +35,9 @@ public:
 		bool force = false;
 		bool verbose = false;
 		bool gui = false;
+		bool history = false; // Always kept in GUI mode.
+		std::size_t spill_history = 0; // Undo steps kept in memory, older ones on disk. 0 : all in memory.
+		std::size_t jobs = 1; // Meshing threads, 1 : serial.
 
 		enum class OutputFormat {
 			CSX,
@@ -57,6 +61,8 @@ public:
 //	void check_x();
 
 	std::expected<void, std::string> parse();
+	std::expected<void, std::string> open_session(std::filesystem::path const& path);
+	std::expected<void, std::string> save_session(std::filesystem::path const& path) const;
 	void run(std::set<Step> const& steps) const;
 	void run_all_steps() const;
 	void run_next_step() const;
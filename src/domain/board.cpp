@@ -5,8 +5,13 @@
 ///*****************************************************************************
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
+#include <optional>
 #include <set>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include "geometrics/bounding.hpp"
@@ -63,9 +68,15 @@ void sort_points_by_vector_orientation(vector<Point>& points, Point const& vecto
 
 //******************************************************************************
 shared_ptr<Board> Board::Builder::build(Params&& params) {
+	// Snapped here, because fixed meshlines may be parsed before the database unit.
+	if(database_unit)
+		for(auto& coords : fixed_meshline_policy_coords)
+			for(Coord& coord : coords)
+				coord = snap(coord);
+
 	return make_shared<Board>(
 		std::move(polygons),
-		std::move(fixed_meshline_policy_creators),
+		std::move(fixed_meshline_policy_coords),
 		std::move(material),
 		std::move(params),
 		Caretaker::singleton().get_history_root());
@@ -76,36 +87,25 @@ void Board::Builder::set_background_material(shared_ptr<Material> background) {
 	material = background;
 }
 
-// TODO should be in meshline manager?
 //******************************************************************************
 void Board::Builder::add_fixed_meshline_policy(Axis const axis, Coord const coord) {
-	fixed_meshline_policy_creators[axis].emplace_back([=](Board const* board, Timepoint* t) {
-		if(!contains_that(board->line_policy_manager->get_current_state().line_policies[axis],
-			[&coord](shared_ptr<MeshlinePolicy> const& policy) {
-				if(policy->get_current_state().policy == MeshlinePolicy::Policy::ONELINE
-				&& policy->get_current_state().normal == MeshlinePolicy::Normal::NONE
-				&& policy->coord == coord)
-					return true;
-				return false;
-			}))
-				board->line_policy_manager->add_meshline_policy(
-					{},
-					axis,
-					MeshlinePolicy::Policy::ONELINE,
-					MeshlinePolicy::Normal::NONE,
-					coord,
-					t);
-	});
+	fixed_meshline_policy_coords[axis].push_back(coord);
 }
 
 //******************************************************************************
 void Board::Builder::add_polygon(Plane plane, shared_ptr<Material> const& material, string const& name, size_t priority, Polygon::RangeZ const& z_placement, initializer_list<Point> points) {
-	polygons[plane].push_back(make_shared<Polygon>(plane, material, name, priority, z_placement, from_init_list(points), Caretaker::singleton().get_history_root()));
+	add_polygon(plane, material, name, priority, z_placement, from_init_list(points));
 }
 
 //******************************************************************************
 void Board::Builder::add_polygon(Plane plane, shared_ptr<Material> const& material, string const& name, size_t priority, Polygon::RangeZ const& z_placement, vector<unique_ptr<Point const>>&& points) {
-	polygons[plane].push_back(make_shared<Polygon>(plane, material, name, priority, z_placement, std::move(points), Caretaker::singleton().get_history_root()));
+	if(database_unit) {
+		for(auto& point : points)
+			point = make_unique<Point const>(snap(*point));
+		polygons[plane].push_back(make_shared<Polygon>(plane, material, name, priority, Polygon::RangeZ(snap(z_placement.min), snap(z_placement.max)), std::move(points), Caretaker::singleton().get_history_root()));
+	} else {
+		polygons[plane].push_back(make_shared<Polygon>(plane, material, name, priority, z_placement, std::move(points), Caretaker::singleton().get_history_root()));
+	}
 }
 
 //******************************************************************************
@@ -116,19 +116,24 @@ void Board::Builder::add_polygon_from_box(Plane plane, shared_ptr<Material> cons
 	points[2] = make_unique<Point const>(p3.x, p3.y);
 	points[3] = make_unique<Point const>(p3.x, p1.y);
 
-	polygons[plane].push_back(make_shared<Polygon>(plane, material, name, priority, z_placement, std::move(points), Caretaker::singleton().get_history_root()));
+	add_polygon(plane, material, name, priority, z_placement, std::move(points));
 }
 
 //******************************************************************************
-BoardState::BoardState(PlaneSpace<vector<shared_ptr<Polygon>>>&& polygons)
-: polygons(std::move(polygons)) {
+BoardState::BoardState(PlaneSpace<vector<shared_ptr<Polygon>>>&& polygons) {
 	for(auto const& plane : AllPlane) {
-		for(auto const& polygon : this->polygons[plane])
+		for(auto const& polygon : polygons[plane])
 			for(auto const& edge : polygon->edges)
 				edges[plane].push_back(edge.get());
 
-		this->polygons[plane].shrink_to_fit();
-		edges[plane].shrink_to_fit();
+		vector<BoundingVolumeHierarchy::Box> boxes;
+		boxes.reserve(polygons[plane].size());
+		for(auto const& polygon : polygons[plane])
+			boxes.push_back({ polygon->bounding, { polygon->z_placement.min, polygon->z_placement.max }});
+		polygons_index[plane] = make_shared<BoundingVolumeHierarchy const>(std::move(boxes));
+		geometry[plane] = make_shared<GeometryStore const>(polygons[plane]);
+
+		this->polygons[plane] = PersistentVector(std::move(polygons[plane]));
 	}
 }
 
@@ -152,7 +157,7 @@ Board::Board(PlaneSpace<vector<shared_ptr<Polygon>>>&& polygons, Params&& params
 //******************************************************************************
 Board::Board(
 	PlaneSpace<std::vector<std::shared_ptr<Polygon>>>&& polygons,
-	AxisSpace<std::vector<std::function<void (Board*, Timepoint*)>>>&& fixed_meshline_policy_creators,
+	AxisSpace<std::vector<Coord>>&& fixed_meshline_policy_coords,
 	shared_ptr<Material>&& background,
 	Params&& params,
 	Timepoint* t)
@@ -161,7 +166,7 @@ Board::Board(
 , conflict_manager(make_shared<ConflictManager>(t))
 , line_policy_manager(make_shared<MeshlinePolicyManager>(global_params.get(), t))
 , material(background)
-, fixed_meshline_policy_creators(std::move(fixed_meshline_policy_creators)) {
+, fixed_meshline_policy_coords(std::move(fixed_meshline_policy_coords)) {
 
 	conflict_manager->init(line_policy_manager.get());
 	line_policy_manager->init(conflict_manager.get());
@@ -180,30 +185,31 @@ shared_ptr<Material> Board::find_ambient_material(Plane plane, Segment const& se
 
 /// Check among all Polygons that match segment and current_polygon->z_placement.
 /// Choose Material following this rule: CONDUCTOR>DIELECTRIC>AIR
+/// Candidates are retrieved from the plane bounding volume hierarchy.
 ///*****************************************************************************
 pair<shared_ptr<Material>, remove_const_t<decltype(Polygon::priority)>> Board::find_ambient_material(Plane plane, Segment const& segment, shared_ptr<Polygon> const& current_polygon) const {
-	Bounding2D const segment_bounding = bounding(segment);
+	auto const& state = get_current_state();
 
-	vector<pair<shared_ptr<Material>, remove_const_t<decltype(Polygon::priority)>>> materials;
-	for(shared_ptr<Polygon> const& polygon : get_current_state().polygons[plane]) {
-		if(polygon->material
-		&& (!current_polygon // Bypass self & z_overlap checks if not relevant.
-		   || (polygon != current_polygon
-		   && does_overlap(polygon->z_placement, current_polygon->z_placement)))
-		&& does_overlap(polygon->bounding, segment_bounding))
-			materials.emplace_back(shared_ptr<Material>(polygon->material), polygon->priority);
-	}
+	optional<Bounding1D> z_placement; // Bypass z_overlap check if not relevant.
+	if(current_polygon)
+		z_placement = Bounding1D({ current_polygon->z_placement.min, current_polygon->z_placement.max });
 
-	ranges::sort(materials, [](auto const& a, auto const& b) {
-		auto const& [material_a, priority_a] = a;
-		auto const& [material_b, priority_b] = b;
-		return priority_a != priority_b
-		     ? priority_a < priority_b
-		     : *material_a < *material_b;
-	});
+	Polygon const* ambient = nullptr;
+	for(size_t i : state.polygons_index[plane]->find_overlapping(bounding(segment), z_placement)) {
+		Polygon const* polygon = state.polygons[plane][i].get();
+		if(!polygon->material
+		|| polygon == current_polygon.get())
+			continue;
+
+		if(!ambient
+		|| (polygon->priority != ambient->priority
+		   ? polygon->priority > ambient->priority
+		   : !(*polygon->material < *ambient->material)))
+			ambient = polygon;
+	}
 
-	if(!materials.empty())
-		return materials.back();
+	if(ambient)
+		return { ambient->material, ambient->priority };
 	else
 		return { material, std::numeric_limits<remove_const_t<decltype(Polygon::priority)>>::min() };
 }
@@ -251,11 +257,11 @@ void Board::adjust_edges_to_materials(Plane const plane) {
 
 //******************************************************************************
 void Board::detect_diagonal_angles(Plane plane) {
+	auto const guard = lock();
 	auto [t, state] = make_next_state();
 
 	auto [bar, found, k] = Progress::Bar::build(
-		/*state.edges[plane].size() // As many Edges as Polygon::Point
-		+*/ ((state.edges[plane].size() * state.edges[plane].size()) - state.edges[plane].size()) / 2, // AB/BA deduplicated, AA dismissed.
+		state.polygons[plane].size() + state.edges[plane].size(),
 		"["s + to_string(plane) + "] Detecting diagonal Angles ");
 
 // TODO calculate Normals (easy in first case, uneasy in second case)
@@ -263,7 +269,7 @@ void Board::detect_diagonal_angles(Plane plane) {
 	// Angles of polygons, involving a diagonal edge.
 	for(auto const& polygon : state.polygons[plane]) {
 		size_t p = polygon->edges.size() - 1;
-		for(size_t i = 0; i < polygon->edges.size(); ++i, ++k) {
+		for(size_t i = 0; i < polygon->edges.size(); ++i) {
 			if(polygon->edges[p]->axis == Segment::Axis::DIAGONAL
 			|| polygon->edges[i]->axis == Segment::Axis::DIAGONAL) {
 				++found;
@@ -271,37 +277,42 @@ void Board::detect_diagonal_angles(Plane plane) {
 			}
 			p = i;
 		}
-		bar.tick(found, k);
+		bar.tick(found, ++k);
 	}
 
 	// TODO also inside polygon, except itself, previous and next
 
 	// Crosses between any diagonal edge and any other edge.
-	for(size_t i = 0; i < state.polygons[plane].size(); ++i) {
-		for(size_t l = 0; l < state.polygons[plane][i]->edges.size(); ++l) {
-			auto& edge_a = state.polygons[plane][i]->edges[l];
-
-			for(size_t j = i + 1; j < state.polygons[plane].size(); ++j) {
-				for(size_t m = 0; m < state.polygons[plane][j]->edges.size(); ++m, ++k) {
-					auto& edge_b = state.polygons[plane][j]->edges[m];
+	// Broad phase : edges of all polygons are indexed once by their boundings
+	// in the plane GeometryStore, and only edges around a diagonal one are
+	// retrieved. Candidate pairs are then sorted to be tested in the same order
+	// as an all pairs search, edge_a belonging to the first polygon.
+	GeometryStore const& geometry = *state.geometry[plane];
+
+	vector<pair<size_t, size_t>> candidates;
+	for(size_t a = 0; a < geometry.size(); ++a) {
+		if(geometry.axis(a) == Segment::Axis::DIAGONAL)
+			for(size_t b : geometry.edges_index().find_overlapping(geometry.bounding(a)))
+				if(geometry.polygon(a) != geometry.polygon(b))
+					candidates.emplace_back(min(a, b), max(a, b));
+		bar.tick(found, ++k);
+	}
+	ranges::sort(candidates);
+	candidates.erase(unique(begin(candidates), end(candidates)), end(candidates));
 
-					if(edge_a->axis != Segment::Axis::DIAGONAL
-					&& edge_b->axis != Segment::Axis::DIAGONAL)
-						continue;
+	for(auto const& [a, b] : candidates) {
+		if(!does_overlap_strict(geometry.bounding(a), geometry.bounding(b)))
+			continue;
 
-					if(!does_overlap_strict(bounding(*edge_a), bounding(*edge_b)))
-						continue;
+		Edge* edge_a = state.edges[plane][a];
+		Edge* edge_b = state.edges[plane][b];
 
-					relation::SegmentSegment rel = edge_a->relation_to(*edge_b);
-					if(rel == relation::SegmentSegment::CROSSING) {
-						if(optional<Point> p = intersection(*edge_a, *edge_b)) {
-							++found;
-							state.angles[plane].emplace_back(make_shared<Angle>(p.value(), edge_a.get(), edge_b.get(), t));
-						}
-					}
-				}
+		relation::SegmentSegment rel = edge_a->relation_to(*edge_b);
+		if(rel == relation::SegmentSegment::CROSSING) {
+			if(optional<Point> p = intersection(*edge_a, *edge_b)) {
+				++found;
+				state.angles[plane].emplace_back(make_shared<Angle>(p.value(), edge_a, edge_b, t));
 			}
-			bar.tick(found, k);
 		}
 	}
 
@@ -311,15 +322,32 @@ void Board::detect_diagonal_angles(Plane plane) {
 
 /// Detect all EDGE_IN_POLYGON. Will also detect some COLINEAR_EDGES.
 /// Overlapping edges should be EDGE_IN_POLYGON and not COLINEAR_EDGES.
+///
+/// Broad phase : only Polygon pairs whose boundings and z_placements overlap
+/// are retrieved from the plane bounding volume hierarchy, then only Edges
+/// whose boundings overlap the other Polygon or Edge are actually tested.
+/// Boundings are inflated by equality_tolerance to stay consistent with Coord
+/// equality. Edge boundings are read from the plane GeometryStore.
 ///*****************************************************************************
 void Board::detect_edges_in_polygons(Plane const plane) {
+	auto const& state = get_current_state();
+
 	auto [bar, found, k] = Progress::Bar::build(
-		get_current_state().polygons[plane].size() * get_current_state().polygons[plane].size(),
+		state.polygons[plane].size(),
 		"["s + to_string(plane) + "] Detecting EDGES_IN_POLYGON conflicts ");
 
-	for(auto const& poly_a : get_current_state().polygons[plane]) {
-		for(auto const& poly_b : get_current_state().polygons[plane]) {
-			++k;
+	ConflictManager::Transaction const transaction(*conflict_manager);
+
+	GeometryStore const& geometry = *state.geometry[plane];
+
+	for(size_t a = 0; a < state.polygons[plane].size(); ++a) {
+		auto const& poly_a = state.polygons[plane][a];
+		++k;
+
+		for(size_t b : state.polygons_index[plane]->find_overlapping(
+			inflate(poly_a->bounding, equality_tolerance),
+			Bounding1D({ poly_a->z_placement.min, poly_a->z_placement.max }))) {
+			auto const& poly_b = state.polygons[plane][b];
 
 			if(poly_b == poly_a)
 				continue;
@@ -328,10 +356,14 @@ void Board::detect_edges_in_polygons(Plane const plane) {
 			if(poly_a->priority > poly_b->priority)
 				continue;
 
-			if(!does_overlap(poly_b->z_placement, poly_a->z_placement))
-				continue;
+			auto const [first_a, last_a] = geometry.edges(a);
+			auto const [first_b, last_b] = geometry.edges(b);
+			for(size_t i = first_a; i < last_a; ++i) {
+				Bounding2D const edge_a_bounding = inflate(geometry.bounding(i), equality_tolerance);
+				if(!does_overlap(edge_a_bounding, poly_b->bounding))
+					continue;
 
-			for(auto const& edge_a : poly_a->edges) {
+				Edge* const edge_a = state.edges[plane][i];
 
 				struct RangeBtwIntersections {
 					Range const range;
@@ -352,7 +384,12 @@ void Board::detect_edges_in_polygons(Plane const plane) {
 				vector<Point> intersections;
 				vector<RangeBtwIntersections> ranges;
 
-				for(auto const& edge_b : poly_b->edges) {
+				for(size_t j = first_b; j < last_b; ++j) {
+					if(!does_overlap(edge_a_bounding, geometry.bounding(j)))
+						continue;
+
+					Edge* const edge_b = state.edges[plane][j];
+
 					relation::SegmentSegment rel = edge_a->relation_to(*edge_b);
 					switch(rel) {
 					case relation::SegmentSegment::CROSSING:
@@ -367,7 +404,7 @@ void Board::detect_edges_in_polygons(Plane const plane) {
 								break;
 							ranges.emplace_back(r.value(), relation::PolygonPoint::ON);
 							++found;
-							conflict_manager->add_edge_in_polygon(edge_a.get(), poly_b.get(), r.value(), edge_b.get());
+							conflict_manager->add_edge_in_polygon(edge_a, poly_b.get(), r.value(), edge_b);
 						}
 						break;
 					default:
@@ -383,7 +420,7 @@ void Board::detect_edges_in_polygons(Plane const plane) {
 				&& rel_p0 == relation::PolygonPoint::IN
 				&& rel_p1 == relation::PolygonPoint::IN) {
 					++found;
-					conflict_manager->add_edge_in_polygon(edge_a.get(), poly_b.get());
+					conflict_manager->add_edge_in_polygon(edge_a, poly_b.get());
 				} else if(intersections.size()) {
 					intersections.push_back(edge_a->p0());
 					intersections.push_back(edge_a->p1());
@@ -422,11 +459,11 @@ void Board::detect_edges_in_polygons(Plane const plane) {
 						&& poly_b->relation_to(range.mid.value()) == relation::PolygonPoint::IN) {
 /*						|| poly_b->relation_to(&range.mid.value()) == relation::PolygonPoint::ON))
 */							++found;
-							conflict_manager->add_edge_in_polygon(edge_a.get(), poly_b.get(), range.range);
+							conflict_manager->add_edge_in_polygon(edge_a, poly_b.get(), range.range);
 //							range.rel_to_poly_b = poly_b->relation_to(&range.mid.value()); //TODO useless
 						} else if(range.rel_to_poly_b == relation::PolygonPoint::IN) {
 							++found;
-							conflict_manager->add_edge_in_polygon(edge_a.get(), poly_b.get(), range.range);
+							conflict_manager->add_edge_in_polygon(edge_a, poly_b.get(), range.range);
 						}
 					}
 /*
@@ -449,38 +486,91 @@ void Board::detect_edges_in_polygons(Plane const plane) {
 	bar.complete();
 }
 
-//******************************************************************************
+/// H and V edges are sorted by their constant coord, so that colinear edges end
+/// up in contiguous buckets and only edges of a same bucket are compared.
+/// Buckets whose edges are all equal to each other are reported at once, others
+/// pair by pair. Reports are ordered by edge index, as an all pairs search would.
+///
+/// In fixed-point mode, edges are snapped, so their database units counts are
+/// compared exactly thus transitively : buckets are simply hashed by that count,
+/// and are always reported at once.
+///*****************************************************************************
 void Board::detect_colinear_edges(Plane const plane) {
-	auto const& s = get_current_state();
+	auto const& edges = get_current_state().edges[plane];
 
 	auto [bar, found, k] = Progress::Bar::build(
-		((s.edges[plane].size() * s.edges[plane].size()) - s.edges[plane].size()) / 2, // AB/BA deduplicated, AA dismissed.
+		edges.size(),
 		"["s + to_string(plane) + "] Detecting COLINEAR_EDGES conflicts ");
 
-	for(size_t i = 0; i < s.edges[plane].size(); ++i) {
-		if(s.edges[plane][i]->axis == Segment::Axis::DIAGONAL) {
-//		|| !edges[i]->to_mesh)
-			k += (s.edges[plane].size() - i - 1);
-			bar.tick(found, k);
-			continue;
-		}
+	ConflictManager::Transaction const transaction(*conflict_manager);
 
-		for(size_t j = i + 1; j < s.edges[plane].size(); ++j, ++k) {
-			if(s.edges[plane][j]->axis != s.edges[plane][i]->axis)
-				continue;
+	auto const coord_of = [&edges](size_t i) {
+		return domain::coord(edges[i]->p0(), edges[i]->axis).value();
+	};
 
-			optional<Axis> const axis = transpose(plane, s.edges[plane][i]->axis);
+	vector<size_t> sorted;
+	for(size_t i = 0; i < edges.size(); ++i)
+		if(edges[i]->axis != Segment::Axis::DIAGONAL
+		&& transpose(plane, edges[i]->axis).has_value())
+			sorted.push_back(i);
+	k += edges.size() - sorted.size();
+
+	vector<vector<size_t>> reports;
+	if(database_unit) {
+		array<unordered_map<int64_t, vector<size_t>>, 2> buckets; // H, V.
+		for(size_t i : sorted)
+			buckets[edges[i]->axis == Segment::Axis::H ? 0 : 1][to_database_units(coord_of(i))].push_back(i);
+		k += sorted.size();
+
+		for(auto& axis_buckets : buckets)
+			ranges::for_each(axis_buckets, [&reports](auto& bucket) {
+				if(bucket.second.size() > 1)
+					reports.push_back(std::move(bucket.second)); // Already sorted by edge index.
+			});
+		sorted.clear();
+	}
 
-			if(axis) {
-				if(s.edges[plane][i]->axis == Segment::Axis::H && s.edges[plane][i]->p0().y == s.edges[plane][j]->p0().y) {
-					conflict_manager->add_colinear_edges(s.edges[plane][i], s.edges[plane][j]);
-					++found;
-				} else if(s.edges[plane][i]->axis == Segment::Axis::V && s.edges[plane][i]->p0().x == s.edges[plane][j]->p0().x) {
-					conflict_manager->add_colinear_edges(s.edges[plane][i], s.edges[plane][j]);
-					++found;
-				}
-			}
+	ranges::stable_sort(sorted, [&](size_t a, size_t b) {
+		if(edges[a]->axis != edges[b]->axis)
+			return edges[a]->axis < edges[b]->axis;
+		return coord_of(a) < coord_of(b);
+	});
+
+	for(size_t first = 0, last = 1; first < sorted.size(); first = last++) {
+		while(last < sorted.size()
+		&& edges[sorted[last]]->axis == edges[sorted[first]]->axis
+		&& coord_of(sorted[last]) == coord_of(sorted[last - 1]))
+			++last;
+
+		k += last - first;
+		if(last - first < 2)
+			continue;
+
+		vector<size_t> bucket(begin(sorted) + first, begin(sorted) + last);
+		if(coord_of(sorted[first]) == coord_of(sorted[last - 1])) {
+			ranges::sort(bucket);
+			reports.push_back(std::move(bucket));
+		} else {
+			// Not transitive : report each close enough pair, as the all pairs
+			// search did. The bucket is sorted by coord, so scanning stops at
+			// the first one too far.
+			for(size_t i = 0; i < bucket.size(); ++i)
+				for(size_t j = i + 1; j < bucket.size() && coord_of(bucket[i]) == coord_of(bucket[j]); ++j)
+					reports.push_back({ min(bucket[i], bucket[j]), max(bucket[i], bucket[j]) });
 		}
+	}
+
+	ranges::sort(reports, [](vector<size_t> const& a, vector<size_t> const& b) {
+		return tie(a[0], a[1]) < tie(b[0], b[1]);
+	});
+
+	for(vector<size_t> const& report : reports) {
+		vector<Edge*> colinear_edges;
+		colinear_edges.reserve(report.size());
+		for(size_t i : report)
+			colinear_edges.push_back(edges[i]);
+		conflict_manager->add_colinear_edges(colinear_edges);
+		found += report.size();
 		bar.tick(found, k);
 	}
 	bar.complete();
@@ -495,6 +585,8 @@ void Board::detect_individual_edges(Plane const plane) {
 		+ state.angles[plane].size(),
 		"["s + to_string(plane) + "] Detecting individual Edges ");
 
+	MeshlinePolicyManager::Transaction const transaction(*line_policy_manager);
+
 	for(Edge* edge : state.edges[plane]) {
 		optional<Coord> const coord = domain::coord(edge->p0(), edge->axis);
 		optional<Axis> const axis = transpose(plane, edge->axis);
@@ -552,8 +644,14 @@ void Board::detect_diagonal_zones(Plane plane) {
 		(angles.size() - (angles.size() > 1 ? 1 : 0)) * 2, // Intervals between Angles.
 		"["s + to_string(plane) + "] Detecting diagonal zones ");
 
-	auto diagonal_edges = state.edges[plane]
-		| views::filter([](Edge const* edge) { return edge->get_current_state().to_mesh && edge->axis == Segment::Axis::DIAGONAL; });
+	ConflictManager::Transaction const transaction(*conflict_manager);
+
+	GeometryStore const& geometry = *state.geometry[plane];
+
+	vector<size_t> diagonal_edges;
+	for(size_t i = 0; i < geometry.size(); ++i)
+		if(geometry.axis(i) == Segment::Axis::DIAGONAL)
+			diagonal_edges.push_back(i);
 
 	struct Range {
 		Bounding1D bounding;
@@ -576,8 +674,10 @@ void Board::detect_diagonal_zones(Plane plane) {
 		for(size_t i = 1; i < angles.size(); ++i, ++k) {
 			auto& range = angles_ranges.emplace_back(Range(view_axis, { angles[i-1], angles[i] }));
 
-			for(Edge* edge : diagonal_edges) {
-				if(does_overlap(cast(view_axis, bounding(*edge)), range.mid)) {
+			for(size_t i : diagonal_edges) {
+				Edge* edge = state.edges[plane][i];
+				if(edge->get_current_state().to_mesh
+				&& does_overlap(cast(view_axis, geometry.bounding(i)), range.mid)) {
 					range.edges.emplace(edge);
 				}
 			}
@@ -605,15 +705,34 @@ void Board::detect_diagonal_zones(Plane plane) {
 	bar.complete();
 }
 
+// TODO should be in meshline manager?
 //******************************************************************************
 void Board::add_fixed_meshline_policies(Axis axis) {
 	auto [bar, i, _] = Progress::Bar::build(
-		fixed_meshline_policy_creators[axis].size(),
+		fixed_meshline_policy_coords[axis].size(),
 		"["s + to_string(axis) + "] Adding fixed Meshline Policies ");
 
 	auto* t = next_timepoint();
-	for(auto const& create_meshline_policy : fixed_meshline_policy_creators[axis]) {
-		create_meshline_policy(this, t);
+	MeshlinePolicyManager::Transaction const transaction(*line_policy_manager, t);
+	for(auto const& coord : fixed_meshline_policy_coords[axis]) {
+		auto const is_same = [&coord](shared_ptr<MeshlinePolicy> const& policy) {
+			if(policy->get_current_state().policy == MeshlinePolicy::Policy::ONELINE
+			&& policy->get_current_state().normal == MeshlinePolicy::Normal::NONE
+			&& policy->coord == coord)
+				return true;
+			return false;
+		};
+
+		if(!contains_that(line_policy_manager->get_current_state().line_policies[axis], is_same)
+		&& !contains_that(line_policy_manager->get_pending_meshline_policies(axis), is_same))
+			line_policy_manager->add_meshline_policy(
+				{},
+				axis,
+				MeshlinePolicy::Policy::ONELINE,
+				MeshlinePolicy::Normal::NONE,
+				coord,
+				true,
+				t);
 		bar.tick(++i);
 	}
 	bar.complete();
@@ -709,53 +828,58 @@ void Board::mesh() {
 		line_policy_manager->mesh(axis);
 }
 
+//******************************************************************************
+void Board::mesh_in_parallel(size_t const nthreads) {
+	line_policy_manager->mesh_in_parallel(nthreads);
+}
+
 //******************************************************************************
 vector<shared_ptr<Meshline>> Board::get_meshline_policies_meshlines(Axis axis) const {
 	return line_policy_manager->get_meshline_policies_meshlines(axis);
 }
 
 //******************************************************************************
-vector<shared_ptr<Meshline>> const& Board::get_meshlines(Axis axis) const {
+PersistentVector<shared_ptr<Meshline>> const& Board::get_meshlines(Axis axis) const {
 	return line_policy_manager->get_meshlines(axis);
 }
 
 //******************************************************************************
-vector<shared_ptr<MeshlinePolicy>> const& Board::get_meshline_policies(Axis axis) const {
+PersistentVector<shared_ptr<MeshlinePolicy>> const& Board::get_meshline_policies(Axis axis) const {
 	return line_policy_manager->get_meshline_policies(axis);
 }
 
 //******************************************************************************
-vector<shared_ptr<Interval>> const& Board::get_intervals(Axis axis) const {
+PersistentVector<shared_ptr<Interval>> const& Board::get_intervals(Axis axis) const {
 	return line_policy_manager->get_intervals(axis);
 }
 
 //******************************************************************************
-vector<shared_ptr<Angle>> const& Board::get_angles(Plane plane) const {
+PersistentVector<shared_ptr<Angle>> const& Board::get_angles(Plane plane) const {
 	return get_current_state().angles[plane];
 }
 
 //******************************************************************************
-vector<shared_ptr<Polygon>> const& Board::get_polygons(Plane plane) const {
+PersistentVector<shared_ptr<Polygon>> const& Board::get_polygons(Plane plane) const {
 	return get_current_state().polygons[plane];
 }
 
 //******************************************************************************
-vector<shared_ptr<ConflictEdgeInPolygon>> const& Board::get_conflicts_edge_in_polygons(Plane const plane) const {
+PersistentVector<shared_ptr<ConflictEdgeInPolygon>> const& Board::get_conflicts_edge_in_polygons(Plane const plane) const {
 	return conflict_manager->get_edge_in_polygons(plane);
 }
 
 //******************************************************************************
-vector<shared_ptr<ConflictColinearEdges>> const& Board::get_conflicts_colinear_edges(Axis const axis) const {
+PersistentVector<shared_ptr<ConflictColinearEdges>> const& Board::get_conflicts_colinear_edges(Axis const axis) const {
 	return conflict_manager->get_colinear_edges(axis);
 }
 
 //******************************************************************************
-vector<shared_ptr<ConflictTooCloseMeshlinePolicies>> const& Board::get_conflicts_too_close_meshline_policies(Axis const axis) const {
+PersistentVector<shared_ptr<ConflictTooCloseMeshlinePolicies>> const& Board::get_conflicts_too_close_meshline_policies(Axis const axis) const {
 	return conflict_manager->get_too_close_meshline_policies(axis);
 }
 
 //******************************************************************************
-vector<shared_ptr<ConflictDiagonalOrCircularZone>> const& Board::get_conflicts_diagonal_or_circular_zones(Axis const axis) const {
+PersistentVector<shared_ptr<ConflictDiagonalOrCircularZone>> const& Board::get_conflicts_diagonal_or_circular_zones(Axis const axis) const {
 	return conflict_manager->get_diagonal_or_circular_zones(axis);
 }
 
@@ -764,5 +888,15 @@ size_t Board::get_mesh_cell_number() const {
 	return line_policy_manager->get_mesh_cell_number();
 }
 
+//******************************************************************************
+ConflictManager& Board::get_conflict_manager() const noexcept {
+	return *conflict_manager;
+}
+
+//******************************************************************************
+MeshlinePolicyManager& Board::get_meshline_policy_manager() const noexcept {
+	return *line_policy_manager;
+}
+
 
 } // namespace domain
@@ -15,12 +15,15 @@
 
 #include "conflicts/conflict.hpp"
 #include "geometrics/angle.hpp"
+#include "geometrics/bounding_volume_hierarchy.hpp"
 #include "geometrics/edge.hpp"
+#include "geometrics/geometry_store.hpp"
 #include "geometrics/point.hpp"
 #include "geometrics/polygon.hpp"
 #include "geometrics/space.hpp"
 #include "utils/entity.hpp"
 #include "utils/entity_visitor.hpp"
+#include "utils/persistent_vector.hpp"
 #include "utils/state_management.hpp"
 #include "conflict_manager.hpp"
 #include "global.hpp"
@@ -37,9 +40,11 @@ namespace domain {
 
 //******************************************************************************
 struct BoardState final {
-	PlaneSpace<std::vector<std::shared_ptr<Polygon>>> polygons;
-	PlaneSpace<std::vector<Edge*>> edges;
-	PlaneSpace<std::vector<std::shared_ptr<Angle>>> angles;
+	PlaneSpace<PersistentVector<std::shared_ptr<Polygon>>> polygons;
+	PlaneSpace<PersistentVector<Edge*>> edges;
+	PlaneSpace<PersistentVector<std::shared_ptr<Angle>>> angles;
+	PlaneSpace<std::shared_ptr<BoundingVolumeHierarchy const>> polygons_index; // Shared between states, indices match polygons.
+	PlaneSpace<std::shared_ptr<GeometryStore const>> geometry; // Shared between states, indices match polygons & edges.
 
 	explicit BoardState(PlaneSpace<std::vector<std::shared_ptr<Polygon>>>&& polygons);
 };
@@ -71,16 +76,16 @@ public:
 	private:
 		std::shared_ptr<Material> material;
 		PlaneSpace<std::vector<std::shared_ptr<Polygon>>> polygons;
-		AxisSpace<std::vector<std::function<void (Board*, Timepoint*)>>> fixed_meshline_policy_creators;
+		AxisSpace<std::vector<Coord>> fixed_meshline_policy_coords;
 	};
 
 	std::shared_ptr<Material> material;
-	AxisSpace<std::vector<std::function<void (Board*, Timepoint*)>>> const fixed_meshline_policy_creators; // Meant to delay MeshlinePolicies creation at Step time instead of Parse time.
+	AxisSpace<std::vector<Coord>> const fixed_meshline_policy_coords; // Meant to delay MeshlinePolicies creation at Step time instead of Parse time.
 
 	Board(PlaneSpace<std::vector<std::shared_ptr<Polygon>>>&& polygons, Params&& params, Timepoint* t);
 	Board(
 		PlaneSpace<std::vector<std::shared_ptr<Polygon>>>&& polygons,
-		AxisSpace<std::vector<std::function<void (Board*, Timepoint*)>>>&& fixed_meshline_policy_creators,
+		AxisSpace<std::vector<Coord>>&& fixed_meshline_policy_coords,
 		std::shared_ptr<Material>&& background,
 		Params&& params,
 		Timepoint* t);
@@ -113,19 +118,25 @@ public:
 	void detect_intervals();
 	void detect_intervals_per_diagonal_zones();
 	void mesh();
+	void mesh_in_parallel(std::size_t nthreads);
 
 	std::vector<std::shared_ptr<Meshline>> get_meshline_policies_meshlines(Axis axis) const;
-	std::vector<std::shared_ptr<Meshline>> const& get_meshlines(Axis axis) const;
-	std::vector<std::shared_ptr<MeshlinePolicy>> const& get_meshline_policies(Axis axis) const;
-	std::vector<std::shared_ptr<Interval>> const& get_intervals(Axis axis) const;
-	std::vector<std::shared_ptr<Polygon>> const& get_polygons(Plane plane) const;
-	std::vector<std::shared_ptr<Angle>> const& get_angles(Plane plane) const;
-	std::vector<std::shared_ptr<ConflictEdgeInPolygon>> const& get_conflicts_edge_in_polygons(Plane const plane) const;
-	std::vector<std::shared_ptr<ConflictColinearEdges>> const& get_conflicts_colinear_edges(Axis const axis) const;
-	std::vector<std::shared_ptr<ConflictTooCloseMeshlinePolicies>> const& get_conflicts_too_close_meshline_policies(Axis const axis) const;
-	std::vector<std::shared_ptr<ConflictDiagonalOrCircularZone>> const& get_conflicts_diagonal_or_circular_zones(Axis const axis) const;
+	PersistentVector<std::shared_ptr<Meshline>> const& get_meshlines(Axis axis) const;
+	PersistentVector<std::shared_ptr<MeshlinePolicy>> const& get_meshline_policies(Axis axis) const;
+	PersistentVector<std::shared_ptr<Interval>> const& get_intervals(Axis axis) const;
+	PersistentVector<std::shared_ptr<Polygon>> const& get_polygons(Plane plane) const;
+	PersistentVector<std::shared_ptr<Angle>> const& get_angles(Plane plane) const;
+	PersistentVector<std::shared_ptr<ConflictEdgeInPolygon>> const& get_conflicts_edge_in_polygons(Plane const plane) const;
+	PersistentVector<std::shared_ptr<ConflictColinearEdges>> const& get_conflicts_colinear_edges(Axis const axis) const;
+	PersistentVector<std::shared_ptr<ConflictTooCloseMeshlinePolicies>> const& get_conflicts_too_close_meshline_policies(Axis const axis) const;
+	PersistentVector<std::shared_ptr<ConflictDiagonalOrCircularZone>> const& get_conflicts_diagonal_or_circular_zones(Axis const axis) const;
 	std::size_t get_mesh_cell_number() const;
 
+	/// Whole managers, for sessions to save and restore their histories.
+	///*************************************************************************
+	ConflictManager& get_conflict_manager() const noexcept;
+	MeshlinePolicyManager& get_meshline_policy_manager() const noexcept;
+
 private:
 	std::shared_ptr<Material> find_ambient_material(Plane plane, Segment const& segment) const;
 	std::pair<std::shared_ptr<Material>, std::remove_const_t<decltype(Polygon::priority)>> find_ambient_material(Plane plane, Segment const& segment, std::shared_ptr<Polygon> const& current_polygon) const;
@@ -5,6 +5,7 @@
 ///*****************************************************************************
 
 #include <algorithm>
+#include <limits>
 
 #include "geometrics/angle.hpp"
 #include "geometrics/edge.hpp"
@@ -12,6 +13,7 @@
 #include "mesh/meshline_policy.hpp"
 #include "infra/utils/to_string.hpp"
 #include "utils/progress.hpp"
+#include "meshline_policy_manager.hpp"
 
 #include "conflict_manager.hpp"
 
@@ -30,58 +32,124 @@ void ConflictManager::init(MeshlinePolicyManager* _line_policy_manager) {
 	line_policy_manager = _line_policy_manager;
 }
 
+//******************************************************************************
+ConflictManager::Transaction::Transaction(ConflictManager& manager, Timepoint* t)
+: manager(manager)
+, guard(manager.lock())
+{
+	if(!manager.transaction_depth++)
+		manager.transaction_timepoint = t;
+}
+
+//******************************************************************************
+ConflictManager::Transaction::~Transaction() {
+	if(!--manager.transaction_depth)
+		manager.commit_transaction();
+}
+
+/// Copy the current state at first use in a Transaction, and index its
+/// conflicts.
+///*****************************************************************************
+ConflictManagerState& ConflictManager::get_pending_state() {
+	if(pending_state)
+		return pending_state.value();
+
+	auto& state = pending_state.emplace(get_current_state());
+
+	for(auto const& axis : AllAxis) {
+		for(size_t i = 0; i < state.all_colinear_edges[axis].size(); ++i)
+			for(Edge const* edge : state.all_colinear_edges[axis][i]->get_current_state().edges)
+				colinear_edges_index[axis][edge].push_back(i);
+
+		for(auto const& conflict : state.all_too_close_meshline_policies[axis])
+			for(MeshlinePolicy const* policy : conflict->meshline_policies)
+				too_close_meshline_policies_index[axis].insert(policy);
+	}
+
+	for(auto const& plane : AllPlane)
+		for(size_t i = 0; i < state.all_edge_in_polygons[plane].size(); ++i)
+			edge_in_polygons_index[plane].emplace(state.all_edge_in_polygons[plane][i]->edge, i);
+
+	return state;
+}
+
+/// The first timepoint made during a Transaction without given timepoint is
+/// also the one of the resulting state, as it would be without Transaction.
+///*****************************************************************************
+Timepoint* ConflictManager::next_transaction_timepoint() {
+	Timepoint* const t = next_timepoint();
+	if(!transaction_timepoint)
+		transaction_timepoint = t;
+	return t;
+}
+
+//******************************************************************************
+void ConflictManager::commit_transaction() {
+	if(pending_state && is_pending_state_modified)
+		set_given_or_next_state(pending_state.value(), transaction_timepoint);
+
+	pending_state.reset();
+	is_pending_state_modified = false;
+	transaction_timepoint = nullptr;
+	for(auto const& axis : AllAxis) {
+		colinear_edges_index[axis].clear();
+		too_close_meshline_policies_index[axis].clear();
+	}
+	for(auto const& plane : AllPlane)
+		edge_in_polygons_index[plane].clear();
+}
+
+/// If a or b are already registered, the first registered conflict holding one
+/// of them gets the other one.
 /// @warning Allows geometrically inconsistent datas.
 ///*****************************************************************************
 void ConflictManager::add_colinear_edges(Edge* a, Edge* b) {
+	Transaction const transaction(*this);
 	if(a->plane == b->plane && a->axis == b->axis) {
 		auto const axis = transpose(a->plane, a->axis);
 		if(!axis.has_value())
 			return;
 
-		bool does_conflict_exist = false;
-		for(auto const& conflict : get_current_state().all_colinear_edges[axis.value()]) {
-			bool is_a_registered = false;
-			bool is_b_registered = false;
-
-			for(auto const* edge : conflict->get_current_state().edges) {
-				if(edge == a) {
-					is_a_registered = true;
-					if(is_b_registered)
-						break;
-				} else if(edge == b) {
-					is_b_registered = true;
-					if(is_a_registered)
-						break;
-				}
-			}
+		auto& state = get_pending_state();
+		auto& index = colinear_edges_index[axis.value()];
+
+		auto const find_conflicts = [&index](Edge const* edge) -> vector<size_t> const* {
+			auto const it = index.find(edge);
+			return it != end(index) ? &it->second : nullptr;
+		};
+
+		auto const* conflicts_a = find_conflicts(a);
+		auto const* conflicts_b = find_conflicts(b);
+
+		if(conflicts_a || conflicts_b) {
+			size_t const i = min(
+				conflicts_a ? ranges::min(*conflicts_a) : numeric_limits<size_t>::max(),
+				conflicts_b ? ranges::min(*conflicts_b) : numeric_limits<size_t>::max());
+			auto const& conflict = state.all_colinear_edges[axis.value()][i];
+			bool const is_a_registered = conflicts_a && ranges::find(*conflicts_a, i) != end(*conflicts_a);
+			bool const is_b_registered = conflicts_b && ranges::find(*conflicts_b, i) != end(*conflicts_b);
 
 			if(is_a_registered && !is_b_registered) {
-				does_conflict_exist = true;
 				auto* t = next_timepoint();
 				conflict->append(b, t);
 				auto state_b = b->get_current_state();
 				state_b.conflicts.push_back(conflict.get());
 				b->set_state(t, state_b);
-				break;
+				index[b].push_back(i);
 			} else if(!is_a_registered && is_b_registered) {
-				does_conflict_exist = true;
 				auto* t = next_timepoint();
 				conflict->append(a, t);
 				auto state_a = a->get_current_state();
 				state_a.conflicts.push_back(conflict.get());
 				a->set_state(t, state_a);
-				break;
-			} else if(is_a_registered && is_b_registered) {
-				does_conflict_exist = true;
-				break;
+				index[a].push_back(i);
 			}
-		}
-
-		if(!does_conflict_exist) {
-			auto [t, state] = make_next_state();
+		} else {
+			auto* t = next_transaction_timepoint();
 			auto state_a = a->get_current_state();
 			auto state_b = b->get_current_state();
 
+			size_t const i = state.all_colinear_edges[axis.value()].size();
 			auto const& conflict = state.all_colinear_edges[axis.value()].emplace_back(
 				make_shared<ConflictColinearEdges>(axis.value(), a, b, t));
 			get_caretaker().take_care_of(conflict);
@@ -90,11 +158,60 @@ void ConflictManager::add_colinear_edges(Edge* a, Edge* b) {
 
 			a->set_state(t, state_a);
 			b->set_state(t, state_b);
-			set_state(t, state);
+			index[a].push_back(i);
+			index[b].push_back(i);
+			is_pending_state_modified = true;
 		}
 	}
 }
 
+/// Register edges that are all colinear to each other at once. If none of them
+/// is already part of a COLINEAR_EDGES conflict, a single conflict holding all
+/// of them is created under one timepoint, otherwise it falls back to
+/// registering them pair by pair.
+///*****************************************************************************
+void ConflictManager::add_colinear_edges(vector<Edge*> const& edges) {
+	Transaction const transaction(*this);
+	if(edges.size() < 2)
+		return;
+
+	auto const is_registered = [](Edge const* edge) {
+		return ranges::any_of(edge->get_current_state().conflicts, [](Conflict const* conflict) {
+			return conflict->kind == Conflict::Kind::COLINEAR_EDGES;
+		});
+	};
+
+	auto const is_alike = [&edges](Edge const* edge) {
+		return edge->plane == edges.front()->plane && edge->axis == edges.front()->axis;
+	};
+
+	if(ranges::any_of(edges, is_registered) || !ranges::all_of(edges, is_alike)) {
+		for(size_t i = 1; i < edges.size(); ++i)
+			add_colinear_edges(edges.front(), edges[i]);
+		return;
+	}
+
+	auto const axis = transpose(edges.front()->plane, edges.front()->axis);
+	if(!axis.has_value())
+		return;
+
+	auto& state = get_pending_state();
+	auto* t = next_transaction_timepoint();
+	size_t const i = state.all_colinear_edges[axis.value()].size();
+	auto const& conflict = state.all_colinear_edges[axis.value()].emplace_back(
+		make_shared<ConflictColinearEdges>(axis.value(), edges, t));
+	get_caretaker().take_care_of(conflict);
+
+	for(Edge* edge : edges) {
+		auto state_edge = edge->get_current_state();
+		state_edge.conflicts.push_back(conflict.get());
+		edge->set_state(t, state_edge);
+		colinear_edges_index[axis.value()][edge].push_back(i);
+	}
+
+	is_pending_state_modified = true;
+}
+
 /// @warning Allows geometrically inconsistent datas.
 ///*****************************************************************************
 void ConflictManager::add_edge_in_polygon(Edge* a, Polygon* polygon, optional<Edge const*> b) {
@@ -104,35 +221,32 @@ void ConflictManager::add_edge_in_polygon(Edge* a, Polygon* polygon, optional<Ed
 /// @warning Allows geometrically inconsistent datas.
 ///*****************************************************************************
 void ConflictManager::add_edge_in_polygon(Edge* a, Polygon* polygon, Range const range, optional<Edge const*> b) {
+	Transaction const transaction(*this);
 	if(a->plane != polygon->plane
 	&& (!b.has_value() || (*b)->plane != a->plane))
 		return;
 
 	Plane const plane = a->plane;
+	auto& state = get_pending_state();
+	auto& index = edge_in_polygons_index[plane];
 
-	bool does_conflict_exist = false;
-	for(auto const& conflict : get_current_state().all_edge_in_polygons[plane]) {
-		bool is_a_registered = false;
+	if(auto const it = index.find(a); it != end(index)) {
+		auto const& conflict = state.all_edge_in_polygons[plane][it->second];
 		bool is_polygon_registered = false;
 		bool is_overlap_registered = false;
 
-		if(conflict->edge == a) {
-			is_a_registered = true;
-
-			for(Overlap const& overlap : conflict->get_current_state().overlaps) {
-				if(get<POLYGON>(overlap) == polygon) {
-					is_polygon_registered = true;
-					if((get<RANGE>(overlap) == range)
-					&& (!get<EDGE>(overlap) || (get<EDGE>(overlap) && get<EDGE>(overlap).value() == b))) {
-						is_overlap_registered = true;
-						break;
-					}
+		for(Overlap const& overlap : conflict->get_current_state().overlaps) {
+			if(get<POLYGON>(overlap) == polygon) {
+				is_polygon_registered = true;
+				if((get<RANGE>(overlap) == range)
+				&& (!get<EDGE>(overlap) || (get<EDGE>(overlap) && get<EDGE>(overlap).value() == b))) {
+					is_overlap_registered = true;
+					break;
 				}
 			}
 		}
 
-		if(is_a_registered && !is_overlap_registered) {
-			does_conflict_exist = true;
+		if(!is_overlap_registered) {
 			auto* t = next_timepoint();
 			conflict->append(polygon, range, b, t);
 //			b->conflicts.push_back(conflict.get()); // TODO needed?
@@ -141,18 +255,13 @@ void ConflictManager::add_edge_in_polygon(Edge* a, Polygon* polygon, Range const
 				state_p.conflicts.push_back(conflict.get());
 				polygon->set_state(t, state_p);
 			}
-			break;
-		} else if(is_a_registered && is_overlap_registered) {
-			does_conflict_exist = true;
-			break;
 		}
-	}
-
-	if(!does_conflict_exist) {
-		auto [t, state] = make_next_state();
+	} else {
+		auto* t = next_transaction_timepoint();
 		auto state_a = a->get_current_state();
 		auto state_p = polygon->get_current_state();
 
+		index.emplace(a, state.all_edge_in_polygons[plane].size());
 		auto const& conflict = state.all_edge_in_polygons[plane].emplace_back(
 			make_shared<ConflictEdgeInPolygon>(plane, a, polygon, range, b, t));
 		get_caretaker().take_care_of(conflict);
@@ -162,7 +271,7 @@ void ConflictManager::add_edge_in_polygon(Edge* a, Polygon* polygon, Range const
 
 		a->set_state(t, state_a);
 		polygon->set_state(t, state_p);
-		set_state(t, state);
+		is_pending_state_modified = true;
 	}
 }
 
@@ -170,20 +279,19 @@ void ConflictManager::add_edge_in_polygon(Edge* a, Polygon* polygon, Range const
 ConflictTooCloseMeshlinePolicies* ConflictManager::add_too_close_meshline_policies(
 		MeshlinePolicy* a,
 		MeshlinePolicy* b) noexcept {
+	Transaction const transaction(*this);
 
 	if(a->axis != b->axis)
 		return nullptr;
 
 	Axis const axis = a->axis;
+	auto& state = get_pending_state();
+	auto& index = too_close_meshline_policies_index[axis];
 
-	for(auto const& conflict : get_current_state().all_too_close_meshline_policies[axis])
-		if(conflict->meshline_policies[0] == a
-		|| conflict->meshline_policies[0] == b
-		|| conflict->meshline_policies[1] == a
-		|| conflict->meshline_policies[1] == b)
-			return nullptr;
+	if(index.contains(a) || index.contains(b))
+		return nullptr;
 
-	auto [t, state] = make_next_state();
+	auto* t = next_transaction_timepoint();
 	auto state_a = a->get_current_state();
 	auto state_b = b->get_current_state();
 
@@ -197,7 +305,9 @@ ConflictTooCloseMeshlinePolicies* ConflictManager::add_too_close_meshline_polici
 
 	a->set_state(t, state_a);
 	b->set_state(t, state_b);
-	set_state(t, state);
+	index.insert(a);
+	index.insert(b);
+	is_pending_state_modified = true;
 
 	return conflict.get();
 }
@@ -205,7 +315,7 @@ ConflictTooCloseMeshlinePolicies* ConflictManager::add_too_close_meshline_polici
 // TODO merge if two DOCZ in the same axis overlap, coming from two different planes
 //******************************************************************************
 void ConflictManager::add_diagonal_or_circular_zone(Axis axis, vector<Angle*> const& angles, GlobalParams* global_params) {
-	auto [t, state] = make_next_state();
+	Transaction const transaction(*this);
 
 	if(angles.empty())
 		return;
@@ -229,10 +339,12 @@ void ConflictManager::add_diagonal_or_circular_zone(Axis axis, vector<Angle*> co
 	// TODO uneasy merge if the current overlaps with two (or more) other zones
 	// is popping the old ones out safe/fine?
 
+	auto& state = get_pending_state();
+	auto* t = next_transaction_timepoint();
 	auto const& conflict = state.all_diagonal_or_circular_zone[axis].emplace_back(
 		make_shared<ConflictDiagonalOrCircularZone>(axis, sorted_angles, global_params, t));
 
-	set_state(t, state);
+	is_pending_state_modified = true;
 }
 
 //******************************************************************************
@@ -282,6 +394,7 @@ void ConflictManager::auto_solve_all_colinear_edges(Axis const axis) {
 		get_current_state().all_colinear_edges[axis].size(),
 		"["s + to_string(axis) + "] Solving COLINEAR_EDGES conflicts ");
 
+	MeshlinePolicyManager::Transaction const transaction(*line_policy_manager);
 	for(auto const& conflict : get_current_state().all_colinear_edges[axis]) {
 		conflict->auto_solve(*line_policy_manager);
 		bar.tick(i++);
@@ -290,22 +403,22 @@ void ConflictManager::auto_solve_all_colinear_edges(Axis const axis) {
 }
 
 //******************************************************************************
-vector<shared_ptr<ConflictColinearEdges>> const& ConflictManager::get_colinear_edges(Axis const axis) const {
+PersistentVector<shared_ptr<ConflictColinearEdges>> const& ConflictManager::get_colinear_edges(Axis const axis) const {
 	return get_current_state().all_colinear_edges[axis];
 }
 
 //******************************************************************************
-vector<shared_ptr<ConflictEdgeInPolygon>> const& ConflictManager::get_edge_in_polygons(Plane const plane) const {
+PersistentVector<shared_ptr<ConflictEdgeInPolygon>> const& ConflictManager::get_edge_in_polygons(Plane const plane) const {
 	return get_current_state().all_edge_in_polygons[plane];
 }
 
 //******************************************************************************
-vector<shared_ptr<ConflictTooCloseMeshlinePolicies>> const& ConflictManager::get_too_close_meshline_policies(Axis const axis) const {
+PersistentVector<shared_ptr<ConflictTooCloseMeshlinePolicies>> const& ConflictManager::get_too_close_meshline_policies(Axis const axis) const {
 	return get_current_state().all_too_close_meshline_policies[axis];
 }
 
 //******************************************************************************
-vector<shared_ptr<ConflictDiagonalOrCircularZone>> const& ConflictManager::get_diagonal_or_circular_zones(Axis const axis) const {
+PersistentVector<shared_ptr<ConflictDiagonalOrCircularZone>> const& ConflictManager::get_diagonal_or_circular_zones(Axis const axis) const {
 	return get_current_state().all_diagonal_or_circular_zone[axis];
 }
 
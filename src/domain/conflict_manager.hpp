@@ -6,8 +6,12 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 //#include "conflict.hpp"
@@ -16,6 +20,7 @@
 #include "conflicts/conflict_too_close_meshline_policies.hpp"
 #include "conflicts/conflict_diagonal_or_circular_zone.hpp"
 #include "geometrics/space.hpp"
+#include "utils/persistent_vector.hpp"
 #include "utils/state_management.hpp"
 
 namespace domain {
@@ -34,10 +39,10 @@ class GlobalParams;
 
 //******************************************************************************
 struct ConflictManagerState final {
-	PlaneSpace<std::vector<std::shared_ptr<ConflictEdgeInPolygon>>> all_edge_in_polygons;
-	AxisSpace<std::vector<std::shared_ptr<ConflictColinearEdges>>> all_colinear_edges;
-	AxisSpace<std::vector<std::shared_ptr<ConflictTooCloseMeshlinePolicies>>> all_too_close_meshline_policies;
-	AxisSpace<std::vector<std::shared_ptr<ConflictDiagonalOrCircularZone>>> all_diagonal_or_circular_zone;
+	PlaneSpace<PersistentVector<std::shared_ptr<ConflictEdgeInPolygon>>> all_edge_in_polygons;
+	AxisSpace<PersistentVector<std::shared_ptr<ConflictColinearEdges>>> all_colinear_edges;
+	AxisSpace<PersistentVector<std::shared_ptr<ConflictTooCloseMeshlinePolicies>>> all_too_close_meshline_policies;
+	AxisSpace<PersistentVector<std::shared_ptr<ConflictDiagonalOrCircularZone>>> all_diagonal_or_circular_zone;
 };
 
 /// Create / append conflicts regarding already existing conflicts
@@ -47,12 +52,46 @@ class ConflictManager
 private:
 	MeshlinePolicyManager* line_policy_manager;
 
+	std::size_t transaction_depth = 0;
+	Timepoint* transaction_timepoint = nullptr;
+	std::optional<ConflictManagerState> pending_state;
+	bool is_pending_state_modified = false;
+
+	// Indices in pending_state, only valid during a Transaction.
+	AxisSpace<std::unordered_map<Edge const*, std::vector<std::size_t>>> colinear_edges_index;
+	PlaneSpace<std::unordered_map<Edge const*, std::size_t>> edge_in_polygons_index;
+	AxisSpace<std::unordered_set<MeshlinePolicy const*>> too_close_meshline_policies_index;
+
+	ConflictManagerState& get_pending_state();
+	Timepoint* next_transaction_timepoint();
+	void commit_transaction();
+
 public:
+	/// While a Transaction is alive, conflicts registered by the add_*() methods
+	/// are collected in a single pending state instead of a new state per
+	/// conflict, and already registered conflicts are looked up through hash
+	/// indices. The pending state is set when the outermost Transaction ends, at
+	/// t or at the timepoint of the first created conflict. The manager stays
+	/// locked meanwhile, and getters only see the states set before.
+	///*************************************************************************
+	class Transaction {
+	public:
+		explicit Transaction(ConflictManager& manager, Timepoint* t = nullptr);
+		Transaction(Transaction const&) = delete;
+		Transaction& operator=(Transaction const&) = delete;
+		~Transaction();
+
+	private:
+		ConflictManager& manager;
+		std::unique_lock<std::recursive_mutex> const guard;
+	};
+
 	explicit ConflictManager(Timepoint* t);
 
 	void init(MeshlinePolicyManager* _line_policy_manager);
 
 	void add_colinear_edges(Edge* a, Edge* b);
+	void add_colinear_edges(std::vector<Edge*> const& edges);
 
 	void add_edge_in_polygon(Edge* a, Polygon* polygon, std::optional<Edge const*> b = std::nullopt);
 	void add_edge_in_polygon(Edge* a, Polygon* polygon, Range const range, std::optional<Edge const*> b = std::nullopt);
@@ -68,10 +107,10 @@ public:
 	void auto_solve_all_colinear_edges(Axis const axis);
 //	Conflict* find(std::vector<IConflictOrigin> const&);
 
-	std::vector<std::shared_ptr<ConflictColinearEdges>> const& get_colinear_edges(Axis const axis) const;
-	std::vector<std::shared_ptr<ConflictEdgeInPolygon>> const& get_edge_in_polygons(Plane const plane) const;
-	std::vector<std::shared_ptr<ConflictTooCloseMeshlinePolicies>> const& get_too_close_meshline_policies(Axis const axis) const;
-	std::vector<std::shared_ptr<ConflictDiagonalOrCircularZone>> const& get_diagonal_or_circular_zones(Axis const axis) const;
+	PersistentVector<std::shared_ptr<ConflictColinearEdges>> const& get_colinear_edges(Axis const axis) const;
+	PersistentVector<std::shared_ptr<ConflictEdgeInPolygon>> const& get_edge_in_polygons(Plane const plane) const;
+	PersistentVector<std::shared_ptr<ConflictTooCloseMeshlinePolicies>> const& get_too_close_meshline_policies(Axis const axis) const;
+	PersistentVector<std::shared_ptr<ConflictDiagonalOrCircularZone>> const& get_diagonal_or_circular_zones(Axis const axis) const;
 };
 
 #ifdef UNITTEST
@@ -4,6 +4,8 @@
 /// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
 ///*****************************************************************************
 
+#include <utility>
+
 #include "domain/geometrics/edge.hpp"
 #include "domain/mesh/meshline_policy.hpp"
 #include "domain/meshline_policy_manager.hpp"
@@ -22,6 +24,13 @@ ConflictColinearEdges::ConflictColinearEdges(Axis axis, Edge* a, Edge* b, Timepo
 , axis(axis)
 {}
 
+//******************************************************************************
+ConflictColinearEdges::ConflictColinearEdges(Axis axis, vector<Edge*> edges, Timepoint* t)
+: Originator(t, { .edges = std::move(edges) })
+, Conflict(Kind::COLINEAR_EDGES)
+, axis(axis)
+{}
+
 //******************************************************************************
 void ConflictColinearEdges::append(Edge* edge, Timepoint* t) {
 	auto state = get_current_state();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <tuple>
 #include <vector>
 
 #include "domain/geometrics/space.hpp"
@@ -21,6 +22,11 @@ struct ConflictColinearEdgesState final : public ConflictState {
 	std::vector<Edge*> edges;
 };
 
+//******************************************************************************
+inline auto spill_fields(ConflictColinearEdgesState const& state) {
+	return std::tie(state.meshline_policy, state.is_solved, state.solution, state.edges);
+}
+
 //******************************************************************************
 class ConflictColinearEdges
 : public Originator<ConflictColinearEdgesState const>
@@ -30,6 +36,7 @@ public:
 	Axis const axis;
 
 	ConflictColinearEdges(Axis axis, Edge* a, Edge* b, Timepoint* t);
+	ConflictColinearEdges(Axis axis, std::vector<Edge*> edges, Timepoint* t);
 
 	void append(Edge* edge, Timepoint* t = nullptr);
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <tuple>
 #include <vector>
 
 #include "domain/global.hpp"
@@ -28,6 +29,11 @@ struct ConflictDiagonalOrCircularZoneState final : public ConflictState {
 	std::vector<Interval*> intervals;
 };
 
+//******************************************************************************
+inline auto spill_fields(ConflictDiagonalOrCircularZoneState const& state) {
+	return std::tie(state.meshline_policy, state.is_solved, state.solution, state.dmax, state.lmin, state.minimal_angle, state.angles, state.intervals);
+}
+
 //******************************************************************************
 class ConflictDiagonalOrCircularZone
 : public Originator<ConflictDiagonalOrCircularZoneState const>
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <array>
+#include <tuple>
 
 #include "domain/geometrics/space.hpp"
 #include "utils/state_management.hpp"
@@ -19,6 +20,11 @@ struct ConflictTooCloseMeshlinePoliciesState final : public ConflictState {
 	bool is_enabled;
 };
 
+//******************************************************************************
+inline auto spill_fields(ConflictTooCloseMeshlinePoliciesState const& state) {
+	return std::tie(state.meshline_policy, state.is_solved, state.solution, state.is_enabled);
+}
+
 //******************************************************************************
 class ConflictTooCloseMeshlinePolicies
 : public Originator<ConflictTooCloseMeshlinePoliciesState const>
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <tuple>
+
 #include "domain/conflicts/i_conflict_origin.hpp"
 #include "domain/mesh/i_meshline_origin.hpp"
 #include "domain/utils/entity_visitor.hpp"
@@ -26,6 +28,11 @@ struct AngleState final
 	ViewAxisSpace<bool> to_mesh = { false, false };
 };
 
+//******************************************************************************
+inline auto spill_fields(AngleState const& state) {
+	return std::tie(state.conflicts, state.meshline_policy, state.to_mesh);
+}
+
 // TODO IMeshLineOrigin allow 1 MLP while Angle will end in 2 MLPs !!!
 
 //******************************************************************************
@@ -48,5 +48,15 @@ Bounding1D cast(ViewAxis axis, Bounding2D const& a) noexcept {
 	}
 }
 
+/// Grow a bounding box by margin on each side.
+///*****************************************************************************
+Bounding2D inflate(Bounding2D const& a, Coord const& margin) noexcept {
+	return {
+		a[XMIN] - margin,
+		a[XMAX] + margin,
+		a[YMIN] - margin,
+		a[YMAX] + margin };
+}
+
 
 } // namespace domain
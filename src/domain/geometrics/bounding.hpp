@@ -33,4 +33,7 @@ bool does_overlap_strict(Bounding2D const& a, Bounding2D const& b) noexcept;
 //******************************************************************************
 Bounding1D cast(ViewAxis axis, Bounding2D const& a) noexcept;
 
+//******************************************************************************
+Bounding2D inflate(Bounding2D const& a, Coord const& margin) noexcept;
+
 } // namespace domain
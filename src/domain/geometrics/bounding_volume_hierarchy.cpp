@@ -0,0 +1,104 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "bounding_volume_hierarchy.hpp"
+
+namespace domain {
+
+using namespace std;
+
+//******************************************************************************
+static BoundingVolumeHierarchy::Box merge(BoundingVolumeHierarchy::Box const& a, BoundingVolumeHierarchy::Box const& b) noexcept {
+	return {
+		{ min(a.xy[XMIN], b.xy[XMIN]), max(a.xy[XMAX], b.xy[XMAX]),
+		  min(a.xy[YMIN], b.xy[YMIN]), max(a.xy[YMAX], b.xy[YMAX]) },
+		{ min(a.z[XMIN], b.z[XMIN]), max(a.z[XMAX], b.z[XMAX]) }};
+}
+
+//******************************************************************************
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(vector<Box> boxes)
+: boxes(std::move(boxes))
+, items(this->boxes.size()) {
+	iota(begin(items), end(items), 0);
+	if(!items.empty()) {
+		nodes.reserve(2 * (items.size() / leaf_capacity + 1));
+		build(0, items.size());
+	}
+	nodes.shrink_to_fit();
+}
+
+/// Top-down build, splitting items at the median of box centers along the
+/// widest dimension of the plane.
+///*****************************************************************************
+void BoundingVolumeHierarchy::build(size_t first, size_t last) {
+	size_t const i = nodes.size();
+	Box box = boxes[items[first]];
+	for(size_t j = first + 1; j < last; ++j)
+		box = merge(box, boxes[items[j]]);
+	nodes.push_back({ box, first, last - first });
+
+	if(last - first <= leaf_capacity)
+		return;
+
+	BoundingIndex const lo = (box.xy[XMAX] - box.xy[XMIN] >= box.xy[YMAX] - box.xy[YMIN]) ? XMIN : YMIN;
+	BoundingIndex const hi = (lo == XMIN) ? XMAX : YMAX;
+	size_t const mid = first + (last - first) / 2;
+	nth_element(begin(items) + first, begin(items) + mid, begin(items) + last, [&](size_t a, size_t b) {
+		return boxes[a].xy[lo].value() + boxes[a].xy[hi].value()
+		     < boxes[b].xy[lo].value() + boxes[b].xy[hi].value();
+	});
+
+	nodes[i].count = 0;
+	build(first, mid);
+	nodes[i].first = nodes.size();
+	build(mid, last);
+}
+
+//******************************************************************************
+vector<size_t> BoundingVolumeHierarchy::find_overlapping(Bounding2D const& xy, optional<Bounding1D> const& z) const {
+	vector<size_t> found;
+	if(nodes.empty())
+		return found;
+
+	vector<size_t> to_visit({ 0 });
+	while(!to_visit.empty()) {
+		Node const& node = nodes[to_visit.back()];
+		size_t const n = to_visit.back();
+		to_visit.pop_back();
+
+		if(!does_overlap(node.box, xy, z))
+			continue;
+
+		if(node.count) {
+			for(size_t j = node.first; j < node.first + node.count; ++j)
+				if(does_overlap(boxes[items[j]], xy, z))
+					found.push_back(items[j]);
+		} else {
+			to_visit.push_back(node.first);
+			to_visit.push_back(n + 1);
+		}
+	}
+
+	ranges::sort(found);
+	return found;
+}
+
+//******************************************************************************
+size_t BoundingVolumeHierarchy::size() const noexcept {
+	return boxes.size();
+}
+
+//******************************************************************************
+bool does_overlap(BoundingVolumeHierarchy::Box const& a, Bounding2D const& xy, optional<Bounding1D> const& z) noexcept {
+	return does_overlap(a.xy, xy)
+	    && (!z || does_overlap(a.z, z.value()));
+}
+
+} // namespace domain
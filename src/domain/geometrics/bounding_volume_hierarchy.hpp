@@ -0,0 +1,68 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "bounding.hpp"
+
+namespace domain {
+
+#ifdef UNITTEST
+#define private public
+#endif // UNITTEST
+
+/// Static bounding volume hierarchy, built once over a set of boxes made of a
+/// 2D bounding and a normal axis range (eg. Polygon::bounding and
+/// Polygon::z_placement). Queries return the indices of the boxes, as given at
+/// construction, that overlap or just touch the requested one.
+///*****************************************************************************
+class BoundingVolumeHierarchy {
+public:
+	//**************************************************************************
+	struct Box {
+		Bounding2D xy;
+		Bounding1D z;
+	};
+
+	BoundingVolumeHierarchy() = default;
+	explicit BoundingVolumeHierarchy(std::vector<Box> boxes);
+
+	/// If z is nullopt, normal axis overlap is not checked.
+	/// Returned indices are sorted.
+	///*************************************************************************
+	std::vector<std::size_t> find_overlapping(Bounding2D const& xy, std::optional<Bounding1D> const& z = std::nullopt) const;
+
+	std::size_t size() const noexcept;
+
+private:
+	static std::size_t constexpr leaf_capacity = 4;
+
+	//**************************************************************************
+	struct Node {
+		Box box;
+		std::size_t first; // Leaf : first item. Branch : right child, left child is next node.
+		std::size_t count; // Leaf : number of items. Branch : 0.
+	};
+
+	std::vector<Box> boxes;
+	std::vector<std::size_t> items; // Indices of boxes, reordered to be contiguous per leaf.
+	std::vector<Node> nodes;
+
+	void build(std::size_t first, std::size_t last);
+};
+
+#ifdef UNITTEST
+#undef private
+#endif // UNITTEST
+
+//******************************************************************************
+bool does_overlap(BoundingVolumeHierarchy::Box const& a, Bounding2D const& xy, std::optional<Bounding1D> const& z) noexcept;
+
+} // namespace domain
@@ -14,16 +14,6 @@ namespace domain {
 
 using namespace std;
 
-//******************************************************************************
-Coord::operator double() const noexcept {
-	return val;
-}
-
-//******************************************************************************
-double Coord::value() const noexcept {
-	return val;
-}
-
 //******************************************************************************
 bool operator==(Coord const& a, Coord const& b) noexcept {
 	return abs(a.value() - b.value()) < equality_tolerance;
@@ -84,4 +74,16 @@ Coord distance(Coord const& a, Coord const& b) noexcept {
 	return abs(a.value() - b.value());
 }
 
+//******************************************************************************
+Coord snap(Coord const& a) noexcept {
+	if(database_unit)
+		return (double) llround(a.value() / database_unit) * database_unit;
+	return a;
+}
+
+//******************************************************************************
+int64_t to_database_units(Coord const& a) noexcept {
+	return llround(a.value() / (database_unit ? database_unit : equality_tolerance));
+}
+
 } // namespace domain
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+
 namespace domain {
 
 //******************************************************************************
@@ -15,11 +18,12 @@ private:
 
 public:
 	template<typename T>
+	requires std::is_arithmetic_v<T>
 	Coord(T const& value) noexcept : val(value) {}
 	Coord() = default;
 
-	explicit operator double() const noexcept;
-	double value() const noexcept;
+	explicit operator double() const noexcept { return val; }
+	double value() const noexcept { return val; }
 
 	template<typename T>
 	Coord& operator=(T const& a) noexcept {
@@ -80,12 +84,14 @@ Coord operator/(Coord const& a, Coord const& b) noexcept;
 
 //******************************************************************************
 template<typename T>
+requires std::is_arithmetic_v<T>
 bool operator==(T const& a, Coord const& b) noexcept {
 	return Coord(a) == b;
 }
 
 //******************************************************************************
 template<typename T>
+requires std::is_arithmetic_v<T>
 bool operator==(Coord const& a, T const& b) noexcept {
 	return a == Coord(b);
 }
@@ -96,4 +102,13 @@ Coord mid(Coord const& a, Coord const& b) noexcept;
 //******************************************************************************
 Coord distance(Coord const& a, Coord const& b) noexcept;
 
+/// Nearest multiple of database_unit, identity if fixed-point mode is off.
+///*****************************************************************************
+Coord snap(Coord const& a) noexcept;
+
+/// Coord as an integer count of database_unit. Counts equality_tolerance
+/// instead if fixed-point mode is off, which only approximates operator==.
+///*****************************************************************************
+std::int64_t to_database_units(Coord const& a) noexcept;
+
 } // namespace domain
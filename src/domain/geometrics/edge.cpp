@@ -28,7 +28,7 @@ Edge::Edge(Plane const plane, Point const* p0, Point const* p1, Timepoint* t)
 , vec(*p1 - *p0)
 , plane(plane)
 , normal(Normal::NONE)
-//, bounding(bounding(*this))
+, bounding(domain::bounding(*p0, *p1))
 {
 	if(axis == Axis::H) {
 		if(vec.x > 0)
@@ -45,16 +45,6 @@ Edge::Edge(Plane const plane, Point const* p0, Point const* p1, Timepoint* t)
 	}
 }
 
-//******************************************************************************
-Point const& Edge::p0() const noexcept {
-	return *_p0;
-}
-
-//******************************************************************************
-Point const& Edge::p1() const noexcept {
-	return *_p1;
-}
-
 //******************************************************************************
 bool operator==(Range const& a, Edge const& b) noexcept {
 	return (b == a);
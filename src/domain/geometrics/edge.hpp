@@ -8,6 +8,7 @@
 
 #include <array>
 #include <optional>
+#include <tuple>
 #include <vector>
 
 //#include "conflict.hpp"
@@ -46,7 +47,14 @@ struct EdgeState final
 };
 
 //******************************************************************************
-class Edge
+inline auto spill_fields(EdgeState const& state) {
+	return std::tie(state.conflicts, state.conflict, state.meshline_policy, state.to_mesh, state.to_reverse);
+}
+
+/// Final, so that accessors called on an Edge are resolved statically and
+/// inlined, instead of dispatched through Segment.
+///*****************************************************************************
+class Edge final
 : public Originator<EdgeState const>
 , public Visitable<Edge, EntityVisitor>
 , public Entity
@@ -81,12 +89,17 @@ public:
 
 	Normal normal;
 
-//	Bounding2D bounding;
+	Bounding2D const bounding;
 
 	Edge(Plane plane, Point const* p0, Point const* p1, Timepoint* t);
 
-	Point const& p0() const noexcept override;
-	Point const& p1() const noexcept override;
+	Point const& p0() const noexcept final { return *_p0; }
+	Point const& p1() const noexcept final { return *_p1; }
+
+	using Segment::relation_to;
+	relation::SegmentSegment relation_to(Edge const& edge) const noexcept {
+		return relation_between(*_p0, *_p1, *edge._p0, *edge._p1);
+	}
 };
 
 #ifdef UNITTEST
@@ -96,6 +109,12 @@ public:
 //******************************************************************************
 std::optional<Range> merge(Edge const& a, Edge const& b) = delete;
 
+/// Cached at construction, unlike bounding(Segment const&).
+///*****************************************************************************
+inline Bounding2D const& bounding(Edge const& edge) noexcept {
+	return edge.bounding;
+}
+
 //******************************************************************************
 bool operator==(Range const& a, Edge const& b) noexcept;
 bool operator==(Edge const& a, Range const& b) noexcept;
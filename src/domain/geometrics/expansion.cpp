@@ -0,0 +1,56 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <cmath>
+
+#include "expansion.hpp"
+
+namespace domain {
+
+using namespace std;
+
+/// Knuth's branchless exact sum : a + b == x + y.
+///*****************************************************************************
+static inline void two_sum(double const a, double const b, double& x, double& y) noexcept {
+	x = a + b;
+	double const b_virtual = x - a;
+	double const a_virtual = x - b_virtual;
+	y = (a - a_virtual) + (b - b_virtual);
+}
+
+/// Grow-Expansion with zero elimination.
+///*****************************************************************************
+void Expansion::add(double const a) {
+	double q = a;
+	size_t k = 0;
+	for(double const component : components) {
+		double err;
+		two_sum(q, component, q, err);
+		if(err != 0)
+			components[k++] = err;
+	}
+	components.resize(k);
+	if(q != 0)
+		components.push_back(q);
+}
+
+/// The fused multiply-add gives the rounding error of the product exactly.
+///*****************************************************************************
+void Expansion::add_product(double const a, double const b) {
+	double const p = a * b;
+	add(fma(a, b, -p));
+	add(p);
+}
+
+/// The largest component carries the sign of the whole expansion.
+///*****************************************************************************
+int Expansion::sign() const noexcept {
+	if(components.empty())
+		return 0;
+	return (components.back() > 0) - (components.back() < 0);
+}
+
+} // namespace domain
@@ -0,0 +1,43 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+namespace domain {
+
+/// Half the machine epsilon : bound of the relative rounding error of one
+/// floating-point operation.
+///*****************************************************************************
+inline constexpr double rounding_error = std::numeric_limits<double>::epsilon() / 2;
+
+/// Bound of the rounding error of the orient2d() floating-point filter,
+/// relative to |detleft| + |detright|.
+///*****************************************************************************
+inline constexpr double orient2d_error_bound = (3.0 + 16.0 * rounding_error) * rounding_error;
+
+/// Exact sum of floating-point numbers, kept as a nonoverlapping expansion
+/// of components sorted by increasing magnitude.
+/// Cf. J. R. Shewchuk, Adaptive Precision Floating-Point Arithmetic and Fast
+/// Robust Geometric Predicates, 1997.
+///
+/// Only meant for the slow path of adaptive predicates, when the fast
+/// floating-point filter cannot decide.
+///*****************************************************************************
+class Expansion {
+private:
+	std::vector<double> components;
+
+public:
+	void add(double const a);
+	void add_product(double const a, double const b);
+
+	int sign() const noexcept;
+};
+
+} // namespace domain
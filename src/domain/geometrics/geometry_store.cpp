@@ -0,0 +1,106 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <utility>
+
+#include "edge.hpp"
+#include "polygon.hpp"
+
+#include "geometry_store.hpp"
+
+namespace domain {
+
+using namespace std;
+
+//******************************************************************************
+GeometryStore::GeometryStore(vector<shared_ptr<Polygon>> const& polygons) {
+	size_t n_points = 0;
+	for(auto const& polygon : polygons)
+		n_points += polygon->points.size();
+
+	x.reserve(n_points);
+	y.reserve(n_points);
+	edge_vertices.reserve(n_points);
+	edge_bounding.reserve(n_points);
+	edge_axis.reserve(n_points);
+	edge_polygon.reserve(n_points);
+	polygon_edges.reserve(polygons.size() + 1);
+
+	vector<BoundingVolumeHierarchy::Box> boxes;
+	boxes.reserve(n_points);
+
+	polygon_edges.push_back(0);
+	for(size_t p = 0; p < polygons.size(); ++p) {
+		auto const& polygon = polygons[p];
+		auto const first = static_cast<uint32_t>(x.size());
+		auto const n = static_cast<uint32_t>(polygon->points.size());
+
+		for(auto const& point : polygon->points) {
+			x.push_back(point->x.value());
+			y.push_back(point->y.value());
+		}
+
+		// edge[0] is between points[n] & points[0].
+		uint32_t prev = first + n - 1;
+		for(uint32_t i = 0; i < n; ++i) {
+			auto const& edge = polygon->edges[i];
+			edge_vertices.push_back({ prev, first + i });
+			edge_bounding.push_back(domain::bounding(*edge));
+			edge_axis.push_back(edge->axis);
+			edge_polygon.push_back(p);
+			boxes.push_back({ edge_bounding.back(), { 0, 0 }});
+			prev = first + i;
+		}
+
+		polygon_edges.push_back(edge_vertices.size());
+	}
+
+	index = BoundingVolumeHierarchy(std::move(boxes));
+}
+
+//******************************************************************************
+Point GeometryStore::p0(size_t const edge) const noexcept {
+	auto const v = edge_vertices[edge][0];
+	return Point(x[v], y[v]);
+}
+
+//******************************************************************************
+Point GeometryStore::p1(size_t const edge) const noexcept {
+	auto const v = edge_vertices[edge][1];
+	return Point(x[v], y[v]);
+}
+
+//******************************************************************************
+Bounding2D const& GeometryStore::bounding(size_t const edge) const noexcept {
+	return edge_bounding[edge];
+}
+
+//******************************************************************************
+Segment::Axis GeometryStore::axis(size_t const edge) const noexcept {
+	return edge_axis[edge];
+}
+
+//******************************************************************************
+size_t GeometryStore::polygon(size_t const edge) const noexcept {
+	return edge_polygon[edge];
+}
+
+//******************************************************************************
+GeometryStore::EdgeRange GeometryStore::edges(size_t const polygon) const noexcept {
+	return { polygon_edges[polygon], polygon_edges[polygon + 1] };
+}
+
+//******************************************************************************
+BoundingVolumeHierarchy const& GeometryStore::edges_index() const noexcept {
+	return index;
+}
+
+//******************************************************************************
+size_t GeometryStore::size() const noexcept {
+	return edge_vertices.size();
+}
+
+} // namespace domain
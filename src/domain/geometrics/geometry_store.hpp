@@ -0,0 +1,77 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bounding.hpp"
+#include "bounding_volume_hierarchy.hpp"
+#include "point.hpp"
+#include "segment.hpp"
+
+namespace domain {
+
+class Polygon;
+
+#ifdef UNITTEST
+#define private public
+#endif // UNITTEST
+
+/// Contiguous, immutable copy of the geometry of all polygons of a plane, laid
+/// out as structure of arrays so that detection loops stream through flat
+/// arrays instead of chasing Point and Edge pointers.
+///
+/// Edges are numbered as in BoardState::edges : polygon by polygon, in each
+/// polygon edge order. Polygons are numbered as in BoardState::polygons.
+///*****************************************************************************
+class GeometryStore {
+public:
+	//**************************************************************************
+	struct EdgeRange {
+		std::size_t first;
+		std::size_t last; // One past the last edge.
+	};
+
+	GeometryStore() = default;
+	explicit GeometryStore(std::vector<std::shared_ptr<Polygon>> const& polygons);
+
+	Point p0(std::size_t edge) const noexcept;
+	Point p1(std::size_t edge) const noexcept;
+	Bounding2D const& bounding(std::size_t edge) const noexcept;
+	Segment::Axis axis(std::size_t edge) const noexcept;
+	std::size_t polygon(std::size_t edge) const noexcept;
+	EdgeRange edges(std::size_t polygon) const noexcept;
+
+	/// Bounding volume hierarchy over the edge boundings, indices match edges.
+	///*************************************************************************
+	BoundingVolumeHierarchy const& edges_index() const noexcept;
+
+	std::size_t size() const noexcept;
+
+private:
+	std::vector<double> x;
+	std::vector<double> y;
+
+	std::vector<std::array<std::uint32_t, 2>> edge_vertices;
+	std::vector<Bounding2D> edge_bounding;
+	std::vector<Segment::Axis> edge_axis;
+	std::vector<std::size_t> edge_polygon;
+
+	std::vector<std::size_t> polygon_edges; // Size is polygons + 1, polygon i owns [polygon_edges[i], polygon_edges[i+1]).
+
+	BoundingVolumeHierarchy index;
+};
+
+#ifdef UNITTEST
+#undef private
+#endif // UNITTEST
+
+} // namespace domain
@@ -39,11 +39,34 @@ bool operator!=(Point const& a, Point const& b) {
 }
 */
 
+//******************************************************************************
+int orient2d(Point const& a, Point const& b, Point const& c) noexcept {
+	int uncertain = 0;
+	int const sign = orient2d_filter(a, b, c, uncertain);
+	if(!uncertain)
+		return sign;
+
+	// ax (by - cy) + bx (cy - ay) + cx (ay - by), all products being exact.
+	Expansion det;
+	det.add_product(a.x.value(), b.y.value());
+	det.add_product(-a.x.value(), c.y.value());
+	det.add_product(b.x.value(), c.y.value());
+	det.add_product(-b.x.value(), a.y.value());
+	det.add_product(c.x.value(), a.y.value());
+	det.add_product(-c.x.value(), b.y.value());
+	return det.sign();
+}
+
 //******************************************************************************
 Point mid(Point const& a, Point const& b) noexcept {
 	return Point(mid(a.x, b.x), mid(a.y, b.y));
 }
 
+//******************************************************************************
+Point snap(Point const& a) noexcept {
+	return Point(snap(a.x), snap(a.y));
+}
+
 /// Here, @param axis describe the axis of the selected coord of the @param point.
 /// H : H axis : x coord
 /// V : V axis : y coord
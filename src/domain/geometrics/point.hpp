@@ -9,6 +9,7 @@
 #include "space.hpp"
 
 #include "coord.hpp"
+#include "expansion.hpp"
 
 // TODO use std::complex instead of Point?
 
@@ -47,9 +48,36 @@ Point operator*(Point const& p, T const& n) noexcept {
 	return Point(p.x * n, p.y * n);
 }
 
+/// Fast floating-point filter of orient2d() : 1 if (a, b, c) is CCW, -1 if CW.
+/// @param uncertain is set when rounding errors may have decided the sign,
+/// then only orient2d() is reliable. Inline so that batch loops may vectorize
+/// it.
+/// Cf. J. R. Shewchuk, Adaptive Precision Floating-Point Arithmetic and Fast
+/// Robust Geometric Predicates, 1997.
+///*****************************************************************************
+inline int orient2d_filter(Point const& a, Point const& b, Point const& c, int& uncertain) noexcept {
+	double const detleft = (a.x.value() - c.x.value()) * (b.y.value() - c.y.value());
+	double const detright = (a.y.value() - c.y.value()) * (b.x.value() - c.x.value());
+	double const det = detleft - detright;
+	double const detsum = (detleft < 0 ? -detleft : detleft) + (detright < 0 ? -detright : detright);
+	double const errbound = orient2d_error_bound * detsum;
+	uncertain |= (((detleft > 0) & (detright > 0)) | ((detleft < 0) & (detright < 0)))
+	           & (det < errbound) & (-det < errbound);
+	return (det > 0) - (det < 0);
+}
+
+/// Orientation of the triangle (a, b, c) : 1 if CCW, -1 if CW, 0 if exactly
+/// colinear. Adaptive : exact arithmetic only runs when orient2d_filter() is
+/// uncertain.
+///*****************************************************************************
+int orient2d(Point const& a, Point const& b, Point const& c) noexcept;
+
 //******************************************************************************
 Point mid(Point const& a, Point const& b) noexcept;
 
+//******************************************************************************
+Point snap(Point const& a) noexcept;
+
 //******************************************************************************
 Coord coord(Point const& point, ViewAxis const axis) noexcept;
 
@@ -4,8 +4,11 @@
 /// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
 ///*****************************************************************************
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <numbers>
+#include <span>
 
 #include "utils/unreachable.hpp"
 #include "edge.hpp"
@@ -35,6 +38,7 @@ Polygon::Polygon(Plane const plane, shared_ptr<Material> const& material, string
 , name(name)
 , points(std::move(points))
 , edges(detect_edges(this->points, plane, t))
+, vertices(detect_vertices(this->points))
 {
 	detect_edge_normal();
 	for(auto const& edge : edges)
@@ -58,40 +62,72 @@ vector<shared_ptr<Edge>> detect_edges(vector<unique_ptr<Point const>> const& poi
 	return edges;
 }
 
+//******************************************************************************
+vector<Point> detect_vertices(vector<unique_ptr<Point const>> const& points) {
+	vector<Point> vertices;
+	vertices.reserve(points.size() + 1);
+
+	vertices.push_back(*points.back());
+	for(auto const& point : points)
+		vertices.push_back(*point);
+
+	return vertices;
+}
+
 /// Cf. https://rosettacode.org/wiki/Shoelace_formula_for_polygonal_area#C.2B.2B
 /// Cf. https://www.baeldung.com/cs/list-polygon-points-clockwise
 ///
-/// Due to floating point calcul, might fail to detect colinear polygons if
-/// if those are not also colinear to x or y axis? Not problematic though since
-/// FDTD mesh is orthogonal.
+/// Adaptive : the floating-point sum decides unless it is under its rounding
+/// error bound, then the shoelace sum is recomputed exactly. COLINEAR then
+/// means a null area, not an area under equality_tolerance.
 ///*****************************************************************************
 template<class T>
 Polygon::Rotation detect_rotation(T const& points) noexcept {
-	double left_sum = 0.0;
-	double right_sum = 0.0;
+	double sum = 0.0;
+	double sum_abs = 0.0;
 
 	for(size_t i = 0; i < points.size(); ++i) {
 		size_t j = (i + 1) % points.size();
-		left_sum  += double (points[i]->x * points[j]->y);
-		right_sum += double (points[j]->x * points[i]->y);
+		double const left  = points[i]->x.value() * points[j]->y.value();
+		double const right = points[j]->x.value() * points[i]->y.value();
+		sum += left - right;
+		sum_abs += abs(left) + abs(right);
 	}
 
-	double area = 0.5 * (left_sum - right_sum);
+	int sign = (sum > 0) - (sum < 0);
+	double const errbound = (2.0 * (double) points.size() + 2.0) * rounding_error * sum_abs;
+	if(!(sum > errbound || -sum > errbound)) {
+		Expansion area;
+		for(size_t i = 0; i < points.size(); ++i) {
+			size_t j = (i + 1) % points.size();
+			area.add_product(points[i]->x.value(), points[j]->y.value());
+			area.add_product(-points[j]->x.value(), points[i]->y.value());
+		}
+		sign = area.sign();
+	}
 
-	if(Coord(area) == 0)
-		return Polygon::Rotation::COLINEAR;
-	else if(area > 0)
-		return Polygon::Rotation::CCW;
-	else if(area < 0)
-		return Polygon::Rotation::CW;
-	else
-		::unreachable();
+	switch(sign) {
+	case 1: return Polygon::Rotation::CCW;
+	case -1: return Polygon::Rotation::CW;
+	case 0: return Polygon::Rotation::COLINEAR;
+	default: ::unreachable();
+	}
 }
 
 //******************************************************************************
 template Polygon::Rotation detect_rotation(std::vector<std::unique_ptr<Point const>> const&) noexcept;
 template Polygon::Rotation detect_rotation(std::vector<Point const*> const&) noexcept;
 
+/// Same sign than the shoelace formula on three points, but with no container.
+///*****************************************************************************
+Polygon::Rotation detect_rotation(Point const& a, Point const& b, Point const& c) noexcept {
+	switch(orient2d(a, b, c)) {
+	case 1: return Polygon::Rotation::CCW;
+	case -1: return Polygon::Rotation::CW;
+	default: return Polygon::Rotation::COLINEAR;
+	}
+}
+
 //******************************************************************************
 Bounding2D detect_bounding(vector<unique_ptr<Point const>> const& points) noexcept {
 	Bounding2D bounding({
@@ -188,13 +224,18 @@ relation::PolygonPoint Polygon::relation_to(Point const& point) const noexcept {
 		if(need_retry)
 			continue;
 
-		for(auto const& edge : edges) {
+		for(auto const& edge : edges)
 			if(edge->relation_to(point) == relation::SegmentPoint::ON)
 				return relation::PolygonPoint::ON;
 
-			if(edge->relation_to(ray) == relation::SegmentSegment::CROSSING) {
-				++count;
-			}
+		// Count crossings by chunks through the batch relation kernel.
+		span<Point const> const b0s(vertices.data(), edges.size());
+		span<Point const> const b1s(vertices.data() + 1, edges.size());
+		array<relation::SegmentSegment, 64> rels;
+		for(size_t i = 0; i < edges.size(); i += rels.size()) {
+			size_t const size = min(rels.size(), edges.size() - i);
+			relations_to(ray, b0s.subspan(i, size), b1s.subspan(i, size), rels);
+			count += (unsigned int) ranges::count(begin(rels), begin(rels) + size, relation::SegmentSegment::CROSSING);
 		}
 	} while(need_retry);
 
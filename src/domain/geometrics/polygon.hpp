@@ -9,6 +9,7 @@
 #include <initializer_list>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "domain/conflicts/i_conflict_origin.hpp"
@@ -18,6 +19,7 @@
 #include "utils/entity.hpp"
 #include "utils/state_management.hpp"
 #include "bounding.hpp"
+#include "point.hpp"
 #include "relation.hpp"
 #include "space.hpp"
 
@@ -25,12 +27,16 @@ namespace domain {
 
 class Conflict;
 class Edge;
-class Point;
 
 //******************************************************************************
 struct PolygonState final : public IConflictOriginState {
 };
 
+//******************************************************************************
+inline auto spill_fields(PolygonState const& state) {
+	return std::tie(state.conflicts);
+}
+
 //******************************************************************************
 class Polygon
 : public Originator<PolygonState const>
@@ -68,6 +74,11 @@ public:
 	///*************************************************************************
 	std::vector<std::shared_ptr<Edge>> const edges;
 
+	/// Contiguous copy of points, starting by points[n], so that edge[x] is
+	/// between vertices[x] & vertices[x+1].
+	///*************************************************************************
+	std::vector<Point> const vertices;
+
 	Polygon(Plane plane, std::shared_ptr<Material> const& material, std::string const& name, std::size_t priority, RangeZ const& z_placement, std::vector<std::unique_ptr<Point const>>&& points, Timepoint* t);
 	~Polygon() override;
 
@@ -81,9 +92,16 @@ template<class T> Polygon::Rotation detect_rotation(T const& points) noexcept;
 extern template Polygon::Rotation detect_rotation(std::vector<std::unique_ptr<Point const>> const&) noexcept;
 extern template Polygon::Rotation detect_rotation(std::vector<Point const*> const&) noexcept;
 
+/// Allocation-free orientation of the triangle (a, b, c).
+///*****************************************************************************
+Polygon::Rotation detect_rotation(Point const& a, Point const& b, Point const& c) noexcept;
+
 //******************************************************************************
 Bounding2D detect_bounding(std::vector<std::unique_ptr<Point const>> const& points) noexcept;
 
+//******************************************************************************
+std::vector<Point> detect_vertices(std::vector<std::unique_ptr<Point const>> const& points);
+
 //******************************************************************************
 std::vector<std::shared_ptr<Edge>> detect_edges(std::vector<std::unique_ptr<Point const>> const& points, Plane plane, Timepoint* t);
 
@@ -17,16 +17,6 @@ Range::Range(Point const p0, Point const p1) noexcept
 , _p1(p1)
 {}
 
-//******************************************************************************
-Point const& Range::p0() const noexcept {
-	return _p0;
-}
-
-//******************************************************************************
-Point const& Range::p1() const noexcept {
-	return _p1;
-}
-
 //******************************************************************************
 bool operator==(Range const& a, Range const& b) noexcept {
 	return (a.p0() == b.p0() && a.p1() == b.p1()) || (a.p0() == b.p1() && a.p1() == b.p0());
@@ -13,8 +13,10 @@
 
 namespace domain {
 
-//******************************************************************************
-class Range : public Segment/*, public IConflictOrigin*//*, public IMeshLineOrigin*/ {
+/// Final, so that accessors called on a Range are resolved statically and
+/// inlined, instead of dispatched through Segment.
+///*****************************************************************************
+class Range final : public Segment/*, public IConflictOrigin*//*, public IMeshLineOrigin*/ {
 private:
 	Point _p0;
 	Point _p1;
@@ -22,8 +24,13 @@ private:
 public:
 	Range(Point const p0, Point const p1) noexcept;
 
-	Point const& p0() const noexcept override;
-	Point const& p1() const noexcept override;
+	Point const& p0() const noexcept final { return _p0; }
+	Point const& p1() const noexcept final { return _p1; }
+
+	using Segment::relation_to;
+	relation::SegmentSegment relation_to(Range const& range) const noexcept {
+		return relation_between(_p0, _p1, range._p0, range._p1);
+	}
 };
 
 //******************************************************************************
@@ -4,9 +4,10 @@
 /// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
 ///*****************************************************************************
 
+#include <algorithm>
+
 #include "utils/unreachable.hpp"
 #include "point.hpp"
-#include "polygon.hpp"
 #include "range.hpp"
 
 #include "segment.hpp"
@@ -31,46 +32,95 @@ Segment::Segment(Axis const axis) noexcept
 
 /// Cf. https://www.geeksforgeeks.org/check-if-two-given-line-segments-intersect
 /// @warning Assumes both segments are on the same Plane.
+///
+/// Only bitwise logic and arithmetic so that it stays branchless once inlined
+/// in a loop. Relies on relation::SegmentSegment enumerators order.
+///*****************************************************************************
+static inline relation::SegmentSegment classify(int const r1, int const r2, int const r3, int const r4, Point const& a0, Point const& a1, Point const& b0, Point const& b1) noexcept {
+	int const are_colinear = !(r1 | r2 | r3 | r4);
+	int const are_crossing = (r1 != r2) & (r3 != r4);
+	double const ax0 = a0.x.value(), ax1 = a1.x.value(), ay0 = a0.y.value(), ay1 = a1.y.value();
+	double const bx0 = b0.x.value(), bx1 = b1.x.value(), by0 = b0.y.value(), by1 = b1.y.value();
+	double const xmin = max(ax0 < ax1 ? ax0 : ax1, bx0 < bx1 ? bx0 : bx1);
+	double const xmax = min(ax0 > ax1 ? ax0 : ax1, bx0 > bx1 ? bx0 : bx1);
+	double const ymin = max(ay0 < ay1 ? ay0 : ay1, by0 < by1 ? by0 : by1);
+	double const ymax = min(ay0 > ay1 ? ay0 : ay1, by0 > by1 ? by0 : by1);
+	int const do_boundings_overlap = (xmin <= xmax) & (ymin <= ymax);
+
+	// APART, CROSSING, COLINEAR, OVERLAPPING.
+	return static_cast<relation::SegmentSegment>(
+		are_colinear * (2 + do_boundings_overlap) + (1 - are_colinear) * are_crossing);
+}
+
+/// Floating-point filter only, @param uncertain is set when its answer may be
+/// wrong.
 ///*****************************************************************************
+static inline relation::SegmentSegment relation_between(Point const& a0, Point const& a1, Point const& b0, Point const& b1, int& uncertain) noexcept {
+	return classify(
+		orient2d_filter(a0, a1, b0, uncertain),
+		orient2d_filter(a0, a1, b1, uncertain),
+		orient2d_filter(b0, b1, a0, uncertain),
+		orient2d_filter(b0, b1, a1, uncertain),
+		a0, a1, b0, b1);
+}
+
+//******************************************************************************
+static relation::SegmentSegment exact_relation_between(Point const& a0, Point const& a1, Point const& b0, Point const& b1) noexcept {
+	return classify(
+		orient2d(a0, a1, b0),
+		orient2d(a0, a1, b1),
+		orient2d(b0, b1, a0),
+		orient2d(b0, b1, a1),
+		a0, a1, b0, b1);
+}
+
+//******************************************************************************
+relation::SegmentSegment relation_between(Point const& a0, Point const& a1, Point const& b0, Point const& b1) noexcept {
+	int uncertain = 0;
+	relation::SegmentSegment const rel = relation_between(a0, a1, b0, b1, uncertain);
+	return uncertain
+		? exact_relation_between(a0, a1, b0, b1)
+		: rel;
+}
+
+//******************************************************************************
 relation::SegmentSegment Segment::relation_to(Segment const& segment) const {
-	vector<Point const*> v1({ &p0(), &p1(), &segment.p0() });
-	vector<Point const*> v2({ &p0(), &p1(), &segment.p1() });
-	vector<Point const*> v3({ &segment.p0(), &segment.p1(), &p0() });
-	vector<Point const*> v4({ &segment.p0(), &segment.p1(), &p1() });
-	Polygon::Rotation const r1(detect_rotation(v1));
-	Polygon::Rotation const r2(detect_rotation(v2));
-	Polygon::Rotation const r3(detect_rotation(v3));
-	Polygon::Rotation const r4(detect_rotation(v4));
-
-	if(r1 == Polygon::Rotation::COLINEAR && r2 == Polygon::Rotation::COLINEAR
-	&& r3 == Polygon::Rotation::COLINEAR && r4 == Polygon::Rotation::COLINEAR) {
-		Bounding2D const a_bnd(bounding(segment));
-		Bounding2D const b_bnd(bounding(*this));
-
-		if(((a_bnd[XMIN] >= b_bnd[XMIN] && a_bnd[XMIN] <= b_bnd[XMAX]) || (a_bnd[XMAX] >= b_bnd[XMIN] && a_bnd[XMAX] <= b_bnd[XMAX])
-		||  (b_bnd[XMIN] >= a_bnd[XMIN] && b_bnd[XMIN] <= a_bnd[XMAX]) || (b_bnd[XMAX] >= a_bnd[XMIN] && b_bnd[XMAX] <= a_bnd[XMAX]))
-		&& ((a_bnd[YMIN] >= b_bnd[YMIN] && a_bnd[YMIN] <= b_bnd[YMAX]) || (a_bnd[YMAX] >= b_bnd[YMIN] && a_bnd[YMAX] <= b_bnd[YMAX])
-		||  (b_bnd[YMIN] >= a_bnd[YMIN] && b_bnd[YMIN] <= a_bnd[YMAX]) || (b_bnd[YMAX] >= a_bnd[YMIN] && b_bnd[YMAX] <= a_bnd[YMAX])))
-			return relation::SegmentSegment::OVERLAPPING;
-		else
-			return relation::SegmentSegment::COLINEAR;
-	} else if(r1 != r2 && r3 != r4) {
-		return relation::SegmentSegment::CROSSING;
-	} else {
-		return relation::SegmentSegment::APART;
-	}
+	return relation_between(p0(), p1(), segment.p0(), segment.p1());
 }
 
 //******************************************************************************
 relation::SegmentPoint Segment::relation_to(Point const& point) const {
-	vector<Point const*> v({ &p0(), &p1(), &point });
-	return detect_rotation(v) == Polygon::Rotation::COLINEAR
-		&& (point.x <= max(p0().x, p1().x) && point.x >= min(p0().x, p1().x)
-		&&  point.y <= max(p0().y, p1().y) && point.y >= min(p0().y, p1().y))
+	Point const& a = p0();
+	Point const& b = p1();
+	return orient2d(a, b, point) == 0
+		&& (point.x <= max(a.x, b.x) && point.x >= min(a.x, b.x)
+		&&  point.y <= max(a.y, b.y) && point.y >= min(a.y, b.y))
 		? relation::SegmentPoint::ON
 		: relation::SegmentPoint::OUT;
 }
 
+/// The vectorized pass runs the floating-point filter only. Uncertain
+/// relations, which are rare, are then recomputed exactly.
+/// @warning Assumes @param b0s, @param b1s and @param out have the same size.
+///*****************************************************************************
+void relations_to(Segment const& a, span<Point const> const b0s, span<Point const> const b1s, span<relation::SegmentSegment> const out) noexcept {
+	Point const a0 = a.p0();
+	Point const a1 = a.p1();
+
+	int any_uncertain = 0;
+	for(size_t i = 0; i < b0s.size(); ++i)
+		out[i] = relation_between(a0, a1, b0s[i], b1s[i], any_uncertain);
+
+	if(any_uncertain) {
+		for(size_t i = 0; i < b0s.size(); ++i) {
+			int uncertain = 0;
+			relation_between(a0, a1, b0s[i], b1s[i], uncertain);
+			if(uncertain)
+				out[i] = exact_relation_between(a0, a1, b0s[i], b1s[i]);
+		}
+	}
+}
+
 //******************************************************************************
 Segment::Axis axis(Point const& p0, Point const& p1) noexcept {
 	return axis(p1 - p0);
@@ -85,15 +135,20 @@ Segment::Axis axis(Point const& vector) noexcept {
 }
 
 //******************************************************************************
-Bounding2D bounding(Segment const& a) {
+Bounding2D bounding(Point const& p0, Point const& p1) noexcept {
 	Bounding2D bounding;
-	bounding[XMIN] = a.p0().x < a.p1().x ? a.p0().x : a.p1().x;
-	bounding[XMAX] = a.p0().x > a.p1().x ? a.p0().x : a.p1().x;
-	bounding[YMIN] = a.p0().y < a.p1().y ? a.p0().y : a.p1().y;
-	bounding[YMAX] = a.p0().y > a.p1().y ? a.p0().y : a.p1().y;
+	bounding[XMIN] = p0.x < p1.x ? p0.x : p1.x;
+	bounding[XMAX] = p0.x > p1.x ? p0.x : p1.x;
+	bounding[YMIN] = p0.y < p1.y ? p0.y : p1.y;
+	bounding[YMAX] = p0.y > p1.y ? p0.y : p1.y;
 	return bounding;
 }
 
+//******************************************************************************
+Bounding2D bounding(Segment const& a) {
+	return bounding(a.p0(), a.p1());
+}
+
 /// Returns the intersection point between two edges.
 /// @warning Assume both edges are CROSSING.
 ///
@@ -101,6 +156,9 @@ Bounding2D bounding(Segment const& a) {
 ///
 /// Returns nullopt if not crossing edges TODO apart edges
 /// Cf. https://openclassrooms.com/forum/sujet/calcul-du-point-d-intersection-de-deux-segments-21661
+///
+/// Whether b reaches the line of a is decided by exact orientations, only the
+/// position along b is computed in floating-point, then clamped to b.
 ///*****************************************************************************
 optional<Point> intersection(Segment const& a, Segment const& b) {
 	if(a.axis == Segment::Axis::H && b.axis == Segment::Axis::V) {
@@ -111,6 +169,15 @@ optional<Point> intersection(Segment const& a, Segment const& b) {
 		return Point(a.p0().x, b.p0().y);
 	} else if(a.axis == Segment::Axis::DIAGONAL || b.axis == Segment::Axis::DIAGONAL) {
 		// Diagonal
+		int const r0 = orient2d(a.p0(), a.p1(), b.p0());
+		int const r1 = orient2d(a.p0(), a.p1(), b.p1());
+		if(r0 == r1) // Both on the same side, or colinear.
+			return nullopt;
+		if(r0 == 0)
+			return b.p0();
+		if(r1 == 0)
+			return b.p1();
+
 		Point a_vec(a.p1() - a.p0());
 		Point b_vec(b.p1() - b.p0());
 		auto div = double (a_vec.x * b_vec.y - a_vec.y * b_vec.x);
@@ -121,8 +188,7 @@ optional<Point> intersection(Segment const& a, Segment const& b) {
 			       - a_vec.y * a.p0().x
 			       + a_vec.y * b.p0().x)
 			       / div;
-			if(m >= 0 && m <= 1) // When we are not sure edges are crossing.
-				return Point(b.p0() + m * b_vec);
+			return Point(b.p0() + clamp(m, 0.0, 1.0) * b_vec);
 		}
 	}
 	return nullopt;
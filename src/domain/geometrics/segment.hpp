@@ -8,6 +8,7 @@
 
 #include <array>
 #include <optional>
+#include <span>
 
 #include "bounding.hpp"
 #include "relation.hpp"
@@ -38,11 +39,23 @@ public:
 	relation::SegmentPoint relation_to(Point const& point) const;
 };
 
+/// Segment::relation_to(Segment) between [a0, a1] and [b0, b1], without going
+/// through the virtual accessors.
+///*****************************************************************************
+relation::SegmentSegment relation_between(Point const& a0, Point const& a1, Point const& b0, Point const& b1) noexcept;
+
+/// Batch Segment::relation_to(Segment) of @param a against the segments
+/// [b0s[i], b1s[i]], written to out[i]. Branchless over contiguous Points so
+/// that compilers vectorize it.
+///*****************************************************************************
+void relations_to(Segment const& a, std::span<Point const> b0s, std::span<Point const> b1s, std::span<relation::SegmentSegment> out) noexcept;
+
 //******************************************************************************
 Segment::Axis axis(Point const& p0, Point const& p1) noexcept;
 Segment::Axis axis(Point const& vector) noexcept;
 
 //******************************************************************************
+Bounding2D bounding(Point const& p0, Point const& p1) noexcept;
 Bounding2D bounding(Segment const& a);
 
 //******************************************************************************
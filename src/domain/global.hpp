@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstddef>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -30,6 +31,14 @@ struct Params {
 	std::vector<std::pair<Axis, double>> input_fixed_meshlines;
 };
 
+//******************************************************************************
+inline auto spill_fields(Params const& params) {
+	return std::tie(
+		params.has_grid_already, params.proximity_limit, params.smoothness, params.lmin, params.dmax,
+		params.diagonal_lmin, params.diagonal_dmax, params.consecutive_diagonal_minimal_angle,
+		params.input_fixed_meshlines);
+}
+
 //******************************************************************************
 class GlobalParams : public Originator<Params const> {
 public:
@@ -39,4 +48,11 @@ public:
 
 inline double equality_tolerance = 1e-8;
 
+/// Fixed-point mode, off when null. Database unit, in drawing units : parsed
+/// geometry is snapped to its multiples. Coord equality keeps its tolerance,
+/// since derived coords are not snapped, compare to_database_units() instead
+/// where only snapped coords are involved.
+///*****************************************************************************
+inline double database_unit = 0;
+
 } // namespace domain
@@ -17,14 +17,16 @@ namespace domain {
 
 using namespace std;
 
+// Limits the policy d to h, unless limit_d is false, eg. when restoring a
+// session where policy states are restored as they were.
 //******************************************************************************
-Interval::Side::Side(MeshlinePolicy* meshline_policy, size_t lmin, double smoothness, Coord h, function<double (double)> d_init)
+Interval::Side::Side(MeshlinePolicy* meshline_policy, size_t lmin, double smoothness, Coord h, function<double (double)> d_init, bool limit_d)
 : meshline_policy(meshline_policy)
 , lmin(lmin)
 , smoothness(smoothness)
 , d_init_(std::move(d_init))
 {
-	if(meshline_policy->get_current_state().d > h) {
+	if(limit_d && meshline_policy->get_current_state().d > h) {
 		auto state = meshline_policy->get_current_state();
 		state.d = (double) h;
 		meshline_policy->set_next_state(state);
@@ -42,7 +44,7 @@ Coord calc_h(Coord const& a, Coord const& b) noexcept {
 }
 
 //******************************************************************************
-Interval::Interval(MeshlinePolicy* before, MeshlinePolicy* after, Axis axis, GlobalParams* global_params, Timepoint* t)
+Interval::Interval(MeshlinePolicy* before, MeshlinePolicy* after, Axis axis, GlobalParams* global_params, Timepoint* t, bool limit_d)
 : Originator(t, {
 	.dmax = global_params->get_current_state().dmax,
 	.before = Side(before, global_params->get_current_state().lmin, global_params->get_current_state().smoothness, calc_h(before->coord, after->coord), [before](double d) noexcept {
@@ -61,7 +63,7 @@ Interval::Interval(MeshlinePolicy* before, MeshlinePolicy* after, Axis axis, Glo
 		} ();
 		default: ::unreachable();
 		}
-	}),
+	}, limit_d),
 	.after = Side(after, global_params->get_current_state().lmin, global_params->get_current_state().smoothness, calc_h(before->coord, after->coord), [after](double d) noexcept {
 		switch(after->get_current_state().policy) {
 		case MeshlinePolicy::Policy::ONELINE: return 0.0;
@@ -78,7 +80,7 @@ Interval::Interval(MeshlinePolicy* before, MeshlinePolicy* after, Axis axis, Glo
 		} ();
 		default: ::unreachable();
 		}
-	})
+	}, limit_d)
 })
 , global_params(global_params)
 , axis(axis)
@@ -221,37 +223,69 @@ void Interval::update_ls(Interval::Side& side) {
 	side.ls = find_ls(side.meshline_policy->get_current_state().d, side.smoothness, get_current_state().dmax, s(side));
 }
 
-//******************************************************************************
+/// Looks for the largest d, among the ones the former linear search walked
+/// through (d minus d/step at each iteration), that makes ls valid.
+///
+/// As d is never above dmax and every space of find_ls() respects smoothness and
+/// dmax by construction, validity only depends on the line count, that does not
+/// decrease as d decreases. So instead of calling find_ls() at each iteration,
+/// the valid iteration is bracketed by doubling the iteration count, then
+/// bisected. That takes O(log(k)) find_ls() calls for k iterations.
+///
+/// The search also stops once d can no longer decrease, which bounds it even
+/// without iter_limit.
+///*****************************************************************************
 tuple<double, bool> Interval::adjust_d_for_dmax_lmin(Interval::Side const& side, size_t iter_limit) const {
 	size_t const step = 1000;
-	double current_d = min(side.meshline_policy->get_current_state().d, get_current_state().dmax);
-
-	vector<Coord> current_ls = side.ls;
-
-	size_t counter = 0;
-	bool is_limit_reached = false;
-	while(!is_ls_valid_for_dmax_lmin_smoothness(current_ls, current_d, side.smoothness, get_current_state().dmax, side.lmin)) {
-		current_d -= current_d / step;
-		current_ls = find_ls(current_d, side.smoothness, get_current_state().dmax, s(side, current_d));
-
-		if(counter++ >= iter_limit) {
-			is_limit_reached = true;
-			break;
-		}
+	double const dmax = get_current_state().dmax;
+	double const d = min(side.meshline_policy->get_current_state().d, dmax);
+
+	if(is_ls_valid_for_dmax_lmin_smoothness(side.ls, d, side.smoothness, dmax, side.lmin))
+		return { d, false };
+
+	// Former loop reached iteration iter_limit + 1 before giving up.
+	size_t const k_limit = (iter_limit == numeric_limits<size_t>::max()) ? iter_limit : iter_limit + 1;
+
+	auto const decrease = [step](double d, size_t k) {
+		for(; k && d - d / step < d; --k)
+			d -= d / step;
+		return d;
+	};
+
+	auto const is_valid = [&](double d) {
+		return d > 0
+		    && is_ls_valid_for_dmax_lmin_smoothness(find_ls(d, side.smoothness, dmax, s(side, d)), d, side.smoothness, dmax, side.lmin);
+	};
+
+	// Invalid at k_lo, valid at k_hi once bracketed.
+	size_t k_lo = 0;
+	double d_lo = d;
+	size_t k_hi = 1;
+	double d_hi = decrease(d, 1);
+	while(!is_valid(d_hi)) {
+		if(k_hi == k_limit || d_hi == d_lo)
+			return { d_hi, true };
+
+		size_t const k_next = (k_hi > k_limit / 2) ? k_limit : 2 * k_hi;
+		k_lo = k_hi;
+		d_lo = d_hi;
+		d_hi = decrease(d_hi, k_next - k_hi);
+		k_hi = k_next;
 	}
 
-	return { current_d, is_limit_reached };
-
-/*
-	size_t i;
-	for(i = 0; i < iter_limit && !check_ls_dmax_lmin_smoothness(current_ls, current_d, side.smoothness, dmax, side.lmin); ++i) {
-
-		current_d -= current_d / step;
-		current_ls = find_ls(current_d, side.smoothness, dmax, s(side, current_d));
+	while(k_hi - k_lo > 1) {
+		size_t const k_mid = k_lo + (k_hi - k_lo) / 2;
+		double const d_mid = decrease(d_lo, k_mid - k_lo);
+		if(is_valid(d_mid)) {
+			k_hi = k_mid;
+			d_hi = d_mid;
+		} else {
+			k_lo = k_mid;
+			d_lo = d_mid;
+		}
 	}
 
-	return { current_d, i >= iter_limit };
-*/
+	return { d_hi, k_hi == k_limit && k_limit != numeric_limits<size_t>::max() };
 }
 
 //******************************************************************************
@@ -296,67 +330,67 @@ tuple<double, bool> Interval::adjust_d_for_dmax_lmin(Interval::Side const& side,
 //}
 
 // TODO make the previous line go a step further the m line: ls.size()--
-//******************************************************************************
-tuple<double, bool> Interval::adjust_smoothness_for_s(Interval::Side const& side, size_t iter_limit) const {
-	size_t step = 10000;
-	double current_smoothness = side.smoothness;
+/// Looks for the smallest smoothness, among the ones the former linear search
+/// walked through (smoothness minus smoothness/step at each iteration, down to
+/// 1), that does not increase the line count. step sets the relative precision.
+///
+/// The line count does not decrease as smoothness decreases, so the last
+/// accepted iteration is bracketed by doubling the iteration count, then
+/// bisected. The returned iteration count is the number of find_ls() calls.
+///*****************************************************************************
+tuple<double, bool, size_t> Interval::adjust_smoothness_for_s(Interval::Side const& side, size_t iter_limit, size_t step) const {
+	double const d = side.meshline_policy->get_current_state().d;
+	double const dmax = get_current_state().dmax;
+	size_t const nlines = side.ls.size();
 
-	size_t nlines = side.ls.size();
-	vector<Coord> current_ls = side.ls;
+	if(side.smoothness == 1)
+		return { side.smoothness, false, 0 };
 
-	size_t counter = 0;
-	bool is_limit_reached = false;
-/*
-	while(current_smoothness > 1 && current_ls.size() <= nlines) {
-		current_smoothness -= current_smoothness / step;
-		if(current_smoothness < 1)
-			current_smoothness = 1;
+	// Former loop accepted at most iteration iter_limit + 1.
+	size_t const k_limit = (iter_limit == numeric_limits<size_t>::max()) ? iter_limit : iter_limit + 1;
 
-		current_ls = find_ls(side.meshline_policy->get_current_state().d, current_smoothness, dmax, s(side));
+	auto const decrease = [step](double smoothness, size_t k) {
+		for(; k && smoothness != 1; --k)
+			smoothness = max(1.0, smoothness - smoothness / step);
+		return smoothness;
+	};
 
+	size_t counter = 0;
+	auto const is_accepted = [&](double smoothness) {
 		++counter;
-		if(counter >= iter_limit) {
-			is_limit_reached = true;
-			break;
-		}
+		return find_ls(d, smoothness, dmax, s(side)).size() <= nlines;
+	};
+
+	// Accepted at k_lo, rejected at k_hi once bracketed.
+	size_t k_lo = 0;
+	double smoothness_lo = side.smoothness;
+	size_t k_hi = 1;
+	double smoothness_hi = decrease(smoothness_lo, 1);
+	while(is_accepted(smoothness_hi)) {
+		if(smoothness_hi == 1)
+			return { smoothness_hi, false, counter };
+		if(k_hi == k_limit)
+			return { smoothness_hi, true, counter };
+
+		size_t const k_next = (k_hi > k_limit / 2) ? k_limit : 2 * k_hi;
+		k_lo = k_hi;
+		smoothness_lo = smoothness_hi;
+		smoothness_hi = decrease(smoothness_hi, k_next - k_hi);
+		k_hi = k_next;
 	}
-*/
-	for(;;) {
-		double next_smoothness = current_smoothness - current_smoothness / step;
-		if(next_smoothness < 1)
-			next_smoothness = 1;
-
-		auto next_ls = find_ls(side.meshline_policy->get_current_state().d, next_smoothness, get_current_state().dmax, s(side));
-		if(next_ls.size() > nlines)
-			break;
-
-		current_smoothness = next_smoothness;
 
-		if(current_smoothness == 1)
-			break;
-
-		if(counter++ >= iter_limit) {
-			is_limit_reached = true;
-			break;
+	while(k_hi - k_lo > 1) {
+		size_t const k_mid = k_lo + (k_hi - k_lo) / 2;
+		double const smoothness_mid = decrease(smoothness_lo, k_mid - k_lo);
+		if(is_accepted(smoothness_mid)) {
+			k_lo = k_mid;
+			smoothness_lo = smoothness_mid;
+		} else {
+			k_hi = k_mid;
 		}
 	}
 
-/*
-	size_t i;
-	for(i = 0; i < iter_limit && (current_smoothness > 1 && current_ls.size() <= nlines); ++i) {
-		current_smoothness -= current_smoothness / step;
-		if(current_smoothness < 1)
-			current_smoothness = 1;
-
-		current_ls = find_ls(a.meshline_policy->get_current_state().d, current_smoothness, dmax, s(a));
-	}
-
-	if(i >= iter_limit)
-		is_limit_reached = true;
-	return { current_smoothness, i >= iter_limit };
-*/
-
-	return { current_smoothness, is_limit_reached };
+	return { smoothness_lo, false, counter };
 }
 
 //******************************************************************************
@@ -388,8 +422,8 @@ void Interval::auto_solve_smoothness() {
 
 	update_ls(state);
 
-	state.before.smoothness = get<0>(adjust_smoothness_for_s(state.before));
-	state.after.smoothness = get<0>(adjust_smoothness_for_s(state.after));
+	tie(state.before.smoothness, ignore, state.before.smoothness_iterations) = adjust_smoothness_for_s(state.before);
+	tie(state.after.smoothness, ignore, state.after.smoothness_iterations) = adjust_smoothness_for_s(state.after);
 	update_ls(state);
 
 	set_next_state(state);
@@ -51,8 +51,9 @@ public:
 		double smoothness;    ///< Smoothness factor = ]1;2] .
 		std::function<double (double)> const d_init_;
 		std::vector<Coord> ls; // TODO avoid Coord::operator= -> double
+		size_t smoothness_iterations = 0; ///< Iterations taken by the last smoothness adjustment, for diagnostics.
 
-		Side(MeshlinePolicy* meshline_policy, size_t lmin, double smoothness, Coord h, std::function<double (double)> d_init);
+		Side(MeshlinePolicy* meshline_policy, size_t lmin, double smoothness, Coord h, std::function<double (double)> d_init, bool limit_d = true);
 
 		double d_init() const;
 	};
@@ -60,7 +61,7 @@ public:
 	Coord const h;    ///< Distance between a side's coord and the middle m.
 	Coord const m;    ///< Middle between both sides' coord.
 
-	Interval(MeshlinePolicy* before, MeshlinePolicy* after, Axis axis, GlobalParams* global_params, Timepoint* t);
+	Interval(MeshlinePolicy* before, MeshlinePolicy* after, Axis axis, GlobalParams* global_params, Timepoint* t, bool limit_d = true);
 
 	void auto_solve_d();
 	void auto_solve_smoothness();
@@ -77,9 +78,10 @@ private:
 	std::tuple<double, bool> adjust_d_for_dmax_lmin(
 		Side const& side,
 		size_t iter_limit=std::numeric_limits<std::size_t>::max()) const;
-	std::tuple<double, bool> adjust_smoothness_for_s(
+	std::tuple<double, bool, std::size_t> adjust_smoothness_for_s(
 		Side const& side,
-		size_t iter_limit=std::numeric_limits<std::size_t>::max()) const;
+		size_t iter_limit=std::numeric_limits<std::size_t>::max(),
+		size_t step=10000) const;
 };
 
 //******************************************************************************
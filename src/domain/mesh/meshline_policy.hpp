@@ -8,6 +8,7 @@
 
 //#include <memory>
 #include <optional>
+#include <tuple>
 #include <vector>
 
 //#include "conflict.hpp"
@@ -88,6 +89,11 @@ struct MeshlinePolicyState final
 	std::vector<Meshline*> meshlines;
 };
 
+//******************************************************************************
+inline auto spill_fields(MeshlinePolicyState const& state) {
+	return std::tie(state.conflicts, state.conflict, state.policy, state.normal, state.is_enabled, state.d, state.origins, state.meshlines);
+}
+
 //******************************************************************************
 MeshlinePolicy::Normal cast(Normal const normal) noexcept;
 
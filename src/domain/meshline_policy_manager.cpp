@@ -5,7 +5,12 @@
 ///*****************************************************************************
 
 #include <algorithm>
+#include <atomic>
+#include <barrier>
 #include <limits>
+#include <queue>
+#include <thread>
+#include <unordered_map>
 
 #include "domain/geometrics/normal.hpp"
 #include "infra/utils/to_string.hpp"
@@ -32,7 +37,10 @@ MeshlinePolicyManager::MeshlinePolicyManager(
 	GlobalParams* global_params,
 	AxisSpace<std::vector<std::shared_ptr<MeshlinePolicy>>>&& line_policies,
 	Timepoint* t)
-: Originator(t, { .line_policies = std::move(line_policies) })
+: Originator(t, { .line_policies = {
+	PersistentVector(std::move(line_policies[X])),
+	PersistentVector(std::move(line_policies[Y])),
+	PersistentVector(std::move(line_policies[Z])) }})
 , global_params(global_params)
 , conflict_manager(nullptr)
 {
@@ -46,6 +54,38 @@ void MeshlinePolicyManager::init(ConflictManager* _conflict_manager) {
 	conflict_manager = _conflict_manager;
 }
 
+//******************************************************************************
+MeshlinePolicyManager::Transaction::Transaction(MeshlinePolicyManager& manager, Timepoint* t)
+: manager(manager)
+, guard(manager.lock())
+{
+	if(!manager.transaction_depth++)
+		manager.transaction_timepoint = t;
+}
+
+//******************************************************************************
+MeshlinePolicyManager::Transaction::~Transaction() {
+	if(!--manager.transaction_depth)
+		manager.commit_transaction();
+}
+
+//******************************************************************************
+void MeshlinePolicyManager::commit_transaction() {
+	Timepoint* const t = transaction_timepoint;
+	transaction_timepoint = nullptr;
+
+	if(ranges::all_of(AllAxis, [this](Axis axis) { return pending_line_policies[axis].empty(); }))
+		return;
+
+	auto state = get_current_state();
+	for(auto const& axis : AllAxis) {
+		ranges::move(pending_line_policies[axis], back_inserter(state.line_policies[axis]));
+		pending_line_policies[axis].clear();
+	}
+
+	set_given_or_next_state(state, t);
+}
+
 //******************************************************************************
 MeshlinePolicy* MeshlinePolicyManager::add_meshline_policy(
 		vector<IMeshLineOrigin*> origins,
@@ -55,18 +95,16 @@ MeshlinePolicy* MeshlinePolicyManager::add_meshline_policy(
 		Coord const coord,
 		bool const is_enabled,
 		Timepoint* t) {
-
 	if((policy == MeshlinePolicy::Policy::THIRDS && normal == MeshlinePolicy::Normal::NONE)
 	|| (policy != MeshlinePolicy::Policy::THIRDS && normal != MeshlinePolicy::Normal::NONE))
 		return nullptr;
 
-	auto state = get_current_state();
+	Transaction const transaction(*this, t);
 
-	auto const& line_policy = state.line_policies[axis].emplace_back(make_shared<MeshlinePolicy>(
-		axis, policy, normal, global_params, coord, t, origins, is_enabled));
+	auto const& line_policy = pending_line_policies[axis].emplace_back(make_shared<MeshlinePolicy>(
+		axis, policy, normal, global_params, coord, t ? t : transaction_timepoint, origins, is_enabled));
 	get_caretaker().take_care_of(line_policy);
 
-	set_given_or_next_state(state, t);
 	return line_policy.get();
 }
 
@@ -102,23 +140,115 @@ optional<array<MeshlinePolicy*, 2>> detect_closest_meshline_policies(
 		return nullopt;
 }
 
-//******************************************************************************
+/// Solves the closest enabled MeshlinePolicies first, as repeated calls to
+/// detect_closest_meshline_policies() would, but without sorting again all
+/// MeshlinePolicies after each solved conflict.
+///
+/// Enabled MeshlinePolicies are kept as a list sorted by coord and spaces under
+/// the proximity limit between adjacent ones in a min-heap. Solving a conflict
+/// replaces both MeshlinePolicies by the merged one in the list, and only pushes
+/// the spaces around it. Spaces whose sides are no longer adjacent are skipped
+/// when popped.
+///*****************************************************************************
 void MeshlinePolicyManager::detect_and_solve_too_close_meshline_policies(Axis const axis) {
 	auto possible_max = get_current_state().line_policies[axis].size();
 	auto [bar, found, i] = Progress::Bar::build(
 		possible_max,
 		"["s + to_string(axis) + "] Detecting & solving TCMLP conflicts ");
 
-	while(true) {
+	Coord const proximity_limit = global_params->get_current_state().proximity_limit;
+	size_t constexpr none = numeric_limits<size_t>::max();
+
+	//**************************************************************************
+	struct Node {
+		MeshlinePolicy* policy;
+		size_t prev;
+		size_t next; // none once removed from the list.
+	};
+
+	vector<Node> nodes;
+	{
+		auto dimension = create_view(get_current_state().line_policies[axis]);
+
+		erase_if(dimension,
+			[](MeshlinePolicy const* a) {
+				return (!a->get_current_state().is_enabled);
+			});
+
+		ranges::sort(dimension,
+			[](MeshlinePolicy const* a, MeshlinePolicy const* b) {
+				return a->coord < b->coord;
+			});
+
+		nodes.reserve(2 * dimension.size());
+		for(size_t j = 0; j < dimension.size(); ++j)
+			nodes.push_back({ dimension[j], j ? j - 1 : none, j + 1 < dimension.size() ? j + 1 : none });
+	}
+
+	//**************************************************************************
+	struct Space {
+		Coord space;
+		Coord coord; // Of prev, to solve leftmost first among equal spaces.
+		size_t prev;
+		size_t next;
+	};
+
+	auto const is_after = [](Space const& a, Space const& b) {
+		return b.space < a.space
+		    || (!(a.space < b.space) && b.coord < a.coord);
+	};
+
+	priority_queue<Space, vector<Space>, decltype(is_after)> spaces(is_after);
+
+	auto const push_space = [&](size_t prev, size_t next) {
+		if(prev == none || next == none)
+			return;
+
+		Coord space(distance(nodes[prev].policy->coord, nodes[next].policy->coord));
+		if(space <= proximity_limit)
+			spaces.push({ space, nodes[prev].policy->coord, prev, next });
+	};
+
+	for(size_t j = 1; j < nodes.size(); ++j)
+		push_space(j - 1, j);
+
+	Transaction const transaction(*this);
+	ConflictManager::Transaction const conflict_transaction(*conflict_manager);
+	while(!spaces.empty()) {
+		auto const [space, coord, a, b] = spaces.top();
+		spaces.pop();
+		if(nodes[a].next != b)
+			continue;
+
 		++i;
-		auto closest = detect_closest_meshline_policies(create_view(get_current_state().line_policies[axis]), global_params->get_current_state().proximity_limit);
-		if(!closest)
-			break;
-
-		ConflictTooCloseMeshlinePolicies* conflict = conflict_manager->add_too_close_meshline_policies(closest->front(), closest->back());
-		if(conflict) {
-			conflict->auto_solve(*this);
-			bar.tick(++found, i);
+		ConflictTooCloseMeshlinePolicies* conflict = conflict_manager->add_too_close_meshline_policies(nodes[a].policy, nodes[b].policy);
+		if(!conflict)
+			continue;
+
+		conflict->auto_solve(*this);
+		bar.tick(++found, i);
+
+		size_t const prev = nodes[a].prev;
+		size_t const next = nodes[b].next;
+		nodes[a].next = none;
+		nodes[b].next = none;
+
+		size_t middle = none;
+		if(MeshlinePolicy* policy = conflict->get_current_state().meshline_policy; policy) {
+			middle = nodes.size();
+			nodes.push_back({ policy, prev, next });
+		}
+
+		if(prev != none)
+			nodes[prev].next = (middle == none) ? next : middle;
+		if(next != none)
+			nodes[next].prev = (middle == none) ? prev : middle;
+
+		if(middle == none) {
+			push_space(prev, next);
+		} else {
+			push_space(prev, middle);
+			push_space(middle, next);
 		}
 	}
 
@@ -128,6 +258,7 @@ void MeshlinePolicyManager::detect_and_solve_too_close_meshline_policies(Axis co
 
 //******************************************************************************
 void MeshlinePolicyManager::detect_intervals(Axis const axis) {
+	auto const guard = lock();
 	auto [t, state] = make_next_state();
 
 	auto dimension = create_view(state.line_policies[axis]);
@@ -160,89 +291,226 @@ void MeshlinePolicyManager::detect_intervals(Axis const axis) {
 	bar.complete();
 }
 
-//******************************************************************************
+/// Intervals are sorted by middle, so the ones of each zone are found by binary
+/// search. States of Intervals are updated once all zones are processed, so an
+/// Interval in several zones gets all of them under the same timepoint.
+///*****************************************************************************
 void MeshlinePolicyManager::detect_intervals_per_diagonal_zones(Axis const axis) {
+	auto const guard = lock();
 	auto [t, state] = make_next_state();
 
+	auto const& zones = conflict_manager->get_diagonal_or_circular_zones(axis);
+	auto dimension = create_view(state.intervals[axis]);
+
 	auto [bar, found, i] = Progress::Bar::build(
-		conflict_manager->get_diagonal_or_circular_zones(axis).size() * state.intervals[axis].size(),
+		zones.size() + dimension.size(),
 		"["s + to_string(axis) + "] Detecting Intervals per diagonal zones");
 
-	for(auto& conflict : conflict_manager->get_diagonal_or_circular_zones(axis)) {
+	ranges::sort(dimension,
+		[](Interval const* a, Interval const* b) {
+			return a->m < b->m;
+		});
+
+	vector<vector<ConflictDiagonalOrCircularZone*>> zones_per_interval(dimension.size());
+	for(auto const& conflict : zones) {
 		Bounding1D const bounding = conflict->bounding();
+		auto it = lower_bound(begin(dimension), end(dimension), bounding[XMIN],
+			[](Interval const* a, Coord const& b) {
+				return a->m < b;
+			});
+
 		vector<Interval*> intervals;
-		for(auto const& interval : state.intervals[axis]) {
-			++i;
-			if(does_overlap(bounding, interval->m)) {
-				++found;
-				intervals.emplace_back(interval.get());
-				auto state_i = interval->get_current_state();
-				state_i.conflicts.emplace_back(conflict.get());
-				interval->set_state(t, state_i);
-			}
+		for(; it != end(dimension) && does_overlap(bounding, (*it)->m); ++it) {
+			++found;
+			intervals.emplace_back(*it);
+			zones_per_interval[it - begin(dimension)].emplace_back(conflict.get());
 		}
 		conflict->append(intervals, t);
-		bar.tick(found, i);
+		bar.tick(found, ++i);
+	}
+
+	for(size_t j = 0; j < dimension.size(); ++j) {
+		if(!zones_per_interval[j].empty()) {
+			auto state_i = dimension[j]->get_current_state();
+			ranges::copy(zones_per_interval[j], back_inserter(state_i.conflicts));
+			dimension[j]->set_state(t, state_i);
+		}
+		bar.tick(found, ++i);
 	}
 	bar.complete();
 }
 
+// Intervals are solved by increasing size, the result of each one depending on
+// the MeshlinePolicies it shares with already solved neighbours.
+//******************************************************************************
+static vector<Interval*> sort_in_meshing_order(PersistentVector<shared_ptr<Interval>> const& intervals) {
+	auto dimension_view = create_view(intervals);
+
+	ranges::sort(dimension_view,
+		[](Interval const* a, Interval const* b) {
+			return a->h < b->h;
+		});
+
+	return dimension_view;
+}
+
+//******************************************************************************
+static void add_meshlines(
+		PersistentVector<shared_ptr<Meshline>>& meshlines,
+		vector<vector<shared_ptr<Meshline>>>&& interval_meshlines,
+		PersistentVector<shared_ptr<MeshlinePolicy>> const& line_policies,
+		Progress::Bar& bar,
+		size_t& i) {
+
+	for(auto const& line_policy : line_policies) {
+		if(auto meshline = line_policy->mesh(); meshline) {
+			vector<shared_ptr<Meshline>> v;
+			v.push_back(make_shared<Meshline>(meshline.value()));
+			interval_meshlines.emplace_back(std::move(v));
+		}
+		bar.tick(++i);
+	}
+
+	size_t new_size = meshlines.size();
+	for(auto const& it : interval_meshlines)
+		new_size += it.size();
+
+	vector<shared_ptr<Meshline>> sorted;
+	sorted.reserve(new_size);
+	ranges::copy(meshlines, back_inserter(sorted));
+	for(auto& it : interval_meshlines) {
+		ranges::move(it, back_inserter(sorted));
+	}
+
+	ranges::sort(sorted,
+		[](auto const& a, auto const& b) {
+			return *a < *b;
+		});
+
+	meshlines = PersistentVector(std::move(sorted));
+}
+
 //******************************************************************************
 void MeshlinePolicyManager::mesh(Axis const axis) {
+	auto const guard = lock();
 	auto [t, state] = make_next_state();
 
-	auto dimension_view = create_view(state.intervals[axis]);
+	auto const dimension_view = sort_in_meshing_order(state.intervals[axis]);
 
 	auto [bar, i, _] = Progress::Bar::build(
 		dimension_view.size() + state.line_policies[axis].size() + 1,
 		"["s + to_string(axis) + "] Meshing Intervals + Meshline Policies ");
 
-	ranges::sort(dimension_view,
-		[](Interval const* a, Interval const* b) {
-			return a->h < b->h;
-		});
-
 	for(auto interval : dimension_view)
 		interval->auto_solve_d();
 
-	size_t new_size = state.meshlines[axis].size();
 	vector<vector<shared_ptr<Meshline>>> interval_meshlines;
 
 	for(auto* interval : dimension_view) {
 		interval->auto_solve_d();
 		interval->auto_solve_smoothness();
 		interval_meshlines.emplace_back(interval->mesh());
-
-		new_size += interval_meshlines.back().size();
 		bar.tick(++i);
 	}
 
-	for(auto const& line_policy : state.line_policies[axis]) {
-		if(auto meshline = line_policy->mesh(); meshline) {
-			vector<shared_ptr<Meshline>> v;
-			v.push_back(make_shared<Meshline>(meshline.value()));
-			interval_meshlines.emplace_back(std::move(v));
-			++new_size;
+	add_meshlines(state.meshlines[axis], std::move(interval_meshlines), state.line_policies[axis], bar, i);
+
+	set_state(t, state);
+	bar.complete();
+}
+
+/// Same result as meshing each axis serially, using several threads.
+///
+/// Each Interval goes through two passes, as in mesh(Axis). A task (an Interval
+/// in a pass) is scheduled in the wave following the last task that touched one
+/// of its MeshlinePolicies before it in the serial order. Tasks of a same wave
+/// never share a MeshlinePolicy, even across axes since those are independent,
+/// so they run concurrently while every MeshlinePolicy still sees the same
+/// sequence of updates as in serial mode.
+///
+/// Waves run on a pool of nthreads threads, the calling one included, that pick
+/// tasks until the wave is empty then wait for each other.
+///*****************************************************************************
+void MeshlinePolicyManager::mesh_in_parallel(size_t const nthreads) {
+	auto const guard = lock();
+	auto [t, state] = make_next_state();
+
+	struct Task {
+		Interval* interval;
+		bool is_last_pass;
+		vector<shared_ptr<Meshline>>* meshlines;
+	};
+
+	AxisSpace<vector<vector<shared_ptr<Meshline>>>> interval_meshlines;
+	vector<vector<Task>> waves;
+	size_t nsteps = 0;
+
+	for(auto const& axis : AllAxis) {
+		auto const dimension_view = sort_in_meshing_order(state.intervals[axis]);
+		interval_meshlines[axis].resize(dimension_view.size());
+		nsteps += state.line_policies[axis].size() + 1;
+
+		unordered_map<MeshlinePolicy const*, size_t> next_wave;
+		for(bool const is_last_pass : { false, true }) {
+			for(size_t j = 0; j < dimension_view.size(); ++j) {
+				auto const& interval_state = dimension_view[j]->get_current_state();
+				MeshlinePolicy const* before = interval_state.before.meshline_policy;
+				MeshlinePolicy const* after = interval_state.after.meshline_policy;
+
+				size_t const wave = max(next_wave[before], next_wave[after]);
+				next_wave[before] = next_wave[after] = wave + 1;
+
+				if(waves.size() <= wave)
+					waves.resize(wave + 1);
+				waves[wave].push_back({ dimension_view[j], is_last_pass, &interval_meshlines[axis][j] });
+			}
 		}
-		bar.tick(++i);
 	}
 
-	state.meshlines[axis].reserve(new_size);
-	for(auto& it : interval_meshlines) {
-		ranges::move(it, back_inserter(state.meshlines[axis]));
+	auto [bar, i, _] = Progress::Bar::build(
+		waves.size() + nsteps,
+		"[XYZ] Meshing Intervals + Meshline Policies ");
+
+	size_t current_wave = 0; // Only changed while all threads wait.
+	atomic<size_t> next_task = 0;
+	barrier sync(max<size_t>(nthreads, 1), [&]() noexcept {
+		++current_wave;
+		next_task = 0;
+	});
+
+	auto const run_waves = [&](bool const is_caller) {
+		while(current_wave < waves.size()) {
+			auto const& wave = waves[current_wave];
+			for(size_t j = next_task++; j < wave.size(); j = next_task++) {
+				Task const& task = wave[j];
+				task.interval->auto_solve_d();
+				if(task.is_last_pass) {
+					task.interval->auto_solve_smoothness();
+					*task.meshlines = task.interval->mesh();
+				}
+			}
+			sync.arrive_and_wait();
+			if(is_caller)
+				bar.tick(++i);
+		}
+	};
+
+	{
+		vector<jthread> pool;
+		for(size_t n = 1; n < nthreads; ++n)
+			pool.emplace_back(run_waves, false);
+		run_waves(true);
 	}
 
-	ranges::sort(state.meshlines[axis],
-		[](auto const& a, auto const& b) {
-			return *a < *b;
-		});
+	for(auto const& axis : AllAxis)
+		add_meshlines(state.meshlines[axis], std::move(interval_meshlines[axis]), state.line_policies[axis], bar, i);
 
 	set_state(t, state);
 	bar.complete();
 }
 
 //******************************************************************************
-vector<shared_ptr<Meshline>> const& MeshlinePolicyManager::get_meshlines(Axis axis) const {
+PersistentVector<shared_ptr<Meshline>> const& MeshlinePolicyManager::get_meshlines(Axis axis) const {
 	return get_current_state().meshlines[axis];
 }
 
@@ -256,12 +524,17 @@ vector<shared_ptr<Meshline>> MeshlinePolicyManager::get_meshline_policies_meshli
 }
 
 //******************************************************************************
-vector<shared_ptr<MeshlinePolicy>> const& MeshlinePolicyManager::get_meshline_policies(Axis axis) const {
+vector<shared_ptr<MeshlinePolicy>> const& MeshlinePolicyManager::get_pending_meshline_policies(Axis axis) const {
+	return pending_line_policies[axis];
+}
+
+//******************************************************************************
+PersistentVector<shared_ptr<MeshlinePolicy>> const& MeshlinePolicyManager::get_meshline_policies(Axis axis) const {
 	return get_current_state().line_policies[axis];
 }
 
 //******************************************************************************
-vector<shared_ptr<Interval>> const& MeshlinePolicyManager::get_intervals(Axis axis) const {
+PersistentVector<shared_ptr<Interval>> const& MeshlinePolicyManager::get_intervals(Axis axis) const {
 	return get_current_state().intervals[axis];
 }
 
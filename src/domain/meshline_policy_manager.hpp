@@ -7,7 +7,9 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -15,6 +17,7 @@
 #include "mesh/interval.hpp"
 #include "mesh/meshline.hpp"
 #include "mesh/meshline_policy.hpp"
+#include "utils/persistent_vector.hpp"
 #include "utils/state_management.hpp"
 
 namespace domain {
@@ -27,9 +30,9 @@ class ConflictManager;
 
 //******************************************************************************
 struct MeshlinePolicyManagerState final {
-	AxisSpace<std::vector<std::shared_ptr<MeshlinePolicy>>> line_policies;
-	AxisSpace<std::vector<std::shared_ptr<Meshline>>> meshlines;
-	AxisSpace<std::vector<std::shared_ptr<Interval>>> intervals;
+	AxisSpace<PersistentVector<std::shared_ptr<MeshlinePolicy>>> line_policies;
+	AxisSpace<PersistentVector<std::shared_ptr<Meshline>>> meshlines;
+	AxisSpace<PersistentVector<std::shared_ptr<Interval>>> intervals;
 };
 
 //******************************************************************************
@@ -39,7 +42,31 @@ private:
 	GlobalParams* global_params;
 	ConflictManager* conflict_manager;
 
+	std::size_t transaction_depth = 0;
+	Timepoint* transaction_timepoint = nullptr;
+	AxisSpace<std::vector<std::shared_ptr<MeshlinePolicy>>> pending_line_policies;
+
+	void commit_transaction();
+
 public:
+	/// While a Transaction is alive, add_meshline_policy() does not copy the whole
+	/// state per added MeshlinePolicy, but collects them. They are all added as a
+	/// single new state, at a single timepoint, when the outermost Transaction
+	/// ends. The manager stays locked meanwhile.
+	///*************************************************************************
+	class Transaction {
+	public:
+		/// If t is nullptr, the next timepoint is used when needed.
+		explicit Transaction(MeshlinePolicyManager& manager, Timepoint* t = nullptr);
+		Transaction(Transaction const&) = delete;
+		Transaction& operator=(Transaction const&) = delete;
+		~Transaction();
+
+	private:
+		MeshlinePolicyManager& manager;
+		std::unique_lock<std::recursive_mutex> const guard;
+	};
+
 	MeshlinePolicyManager(GlobalParams* global_params, Timepoint* t);
 	MeshlinePolicyManager(
 		GlobalParams* global_params,
@@ -61,15 +88,17 @@ public:
 	void detect_intervals(Axis const axis);
 	void detect_intervals_per_diagonal_zones(Axis const axis);
 	void mesh(Axis const axis);
+	void mesh_in_parallel(std::size_t nthreads);
 
 	void detect_and_solve_too_close_meshline_policies() { for(auto const& axis : AllAxis) detect_and_solve_too_close_meshline_policies(axis); };
 	void detect_intervals() { for(auto const& axis : AllAxis) detect_intervals(axis); };
 	void mesh() { for(auto const& axis : AllAxis) mesh(axis); };
 
 	std::vector<std::shared_ptr<Meshline>> get_meshline_policies_meshlines(Axis axis) const;
-	std::vector<std::shared_ptr<Meshline>> const& get_meshlines(Axis axis) const;
-	std::vector<std::shared_ptr<MeshlinePolicy>> const& get_meshline_policies(Axis axis) const;
-	std::vector<std::shared_ptr<Interval>> const& get_intervals(Axis axis) const;
+	PersistentVector<std::shared_ptr<Meshline>> const& get_meshlines(Axis axis) const;
+	PersistentVector<std::shared_ptr<MeshlinePolicy>> const& get_meshline_policies(Axis axis) const;
+	std::vector<std::shared_ptr<MeshlinePolicy>> const& get_pending_meshline_policies(Axis axis) const; ///< Added during the current Transaction, not in the state yet.
+	PersistentVector<std::shared_ptr<Interval>> const& get_intervals(Axis axis) const;
 	std::size_t get_mesh_cell_number() const;
 };
 
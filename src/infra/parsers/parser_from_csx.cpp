@@ -154,6 +154,10 @@ expected<void, string> ParserFromCsx::Pimpl::parse_grid(pugi::xml_node const& no
 	std::size_t coord_system = node.attribute("CoordSystem").as_uint();
 	std::size_t delta_unit = node.attribute("DeltaUnit").as_uint(1);
 
+	domain::database_unit = params.resolution
+		? params.resolution / node.attribute("DeltaUnit").as_double(1)
+		: 0;
+
 	if(coord_system == 0) {
 		// First step : into bool has_grid_already
 		pugi::xml_node grid = node.child("RectilinearGrid");
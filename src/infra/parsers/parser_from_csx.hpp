@@ -30,6 +30,7 @@ public:
 		bool with_xy = true;
 		bool read_oemsh_params = true;
 		bool keep_old_mesh = false;
+		double resolution = 0; // Fixed-point mode database unit, in meters. 0 : floating-point mode.
 	};
 
 	~ParserFromCsx();
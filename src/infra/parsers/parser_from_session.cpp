@@ -0,0 +1,390 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "domain/mesh/meshline.hpp"
+#include "domain/material.hpp"
+#include "infra/utils/session_format.hpp"
+#include "utils/expected_utils.hpp"
+
+#include "parser_from_session.hpp"
+
+using namespace domain;
+using namespace std;
+
+//******************************************************************************
+template<typename T>
+struct IsStdArray : false_type {};
+template<typename T, size_t N>
+struct IsStdArray<array<T, N>> : true_type {};
+
+//******************************************************************************
+template<typename T>
+concept SharedPtr = same_as<T, shared_ptr<typename T::element_type>>;
+
+//******************************************************************************
+template<typename T>
+concept PushBackable = requires(T container, typename T::value_type value) {
+	container.push_back(value);
+};
+
+//******************************************************************************
+expected<ParserFromSession::Output, string> ParserFromSession::run(filesystem::path const& session, AnnotationReader const& read_annotation) {
+	ifstream file(session, ios::binary);
+	if(!file)
+		return unexpected(format("Failed to open file \"{}\"", session.generic_string()));
+
+	vector<byte> bytes;
+	transform(istreambuf_iterator<char>(file), istreambuf_iterator<char>(), back_inserter(bytes), [](char c) {
+		return static_cast<byte>(c);
+	});
+
+	ParserFromSession parser(bytes, read_annotation);
+	auto output = parser.parse();
+	if(!output)
+		return unexpected(format("Invalid session file \"{}\": {}", session.generic_string(), output.error()));
+	return output;
+}
+
+//******************************************************************************
+ParserFromSession::ParserFromSession(vector<byte> const& bytes, AnnotationReader const& read_annotation)
+: in(bytes)
+, read_annotation(read_annotation)
+{}
+
+// Counterpart of SerializerToSession::write(). Entities are looked up by index
+// and cast to the expected type, anything else fails the reader.
+//******************************************************************************
+template<typename T>
+T ParserFromSession::read() {
+	if constexpr(IsOptional<T>::value) {
+		if(read<bool>())
+			return read<typename T::value_type>();
+		return nullopt;
+	} else if constexpr(is_pointer_v<T> || SharedPtr<T>) {
+		auto const i = read<uint32_t>();
+		if(i == session::none)
+			return nullptr;
+		if(i >= entities.size()) {
+			in.fail();
+			return nullptr;
+		}
+		T entity;
+		if constexpr(SharedPtr<T>)
+			entity = dynamic_pointer_cast<typename T::element_type>(entities[i]);
+		else
+			entity = dynamic_cast<T>(entities[i].get());
+		if(!entity)
+			in.fail();
+		return entity;
+	} else if constexpr(IsPairOrTuple<T>::value) {
+		// Braced initialization, so elements are read in order.
+		return [this]<size_t... I>(index_sequence<I...>) {
+			return T { read<tuple_element_t<I, T>>()... };
+		} (make_index_sequence<tuple_size_v<T>>());
+	} else if constexpr(same_as<T, string>) {
+		string value;
+		in.read(value);
+		return value;
+	} else if constexpr(same_as<T, Range>) {
+		auto const p0 = read<Point>();
+		auto const p1 = read<Point>();
+		return Range(p0, p1);
+	} else if constexpr(IsStdArray<T>::value) {
+		if(read<size_t>() != tuple_size_v<T>)
+			in.fail();
+		return [this]<size_t... I>(index_sequence<I...>) {
+			return T { ((void) I, read<typename T::value_type>())... };
+		} (make_index_sequence<tuple_size_v<T>>());
+	} else if constexpr(PushBackable<T>) {
+		T container;
+		auto const size = read<size_t>();
+		for(size_t i = 0; i < size && !in.has_failed(); ++i)
+			container.push_back(read<typename T::value_type>());
+		return container;
+	} else {
+		// Some trivially copyable types, like Point, are not default constructible.
+		array<byte, sizeof(T)> bytes {};
+		in.read(bytes);
+		return bit_cast<T>(bytes);
+	}
+}
+
+//******************************************************************************
+Timepoint* ParserFromSession::read_timepoint() {
+	auto const i = read<uint32_t>();
+	if(i == session::none)
+		return nullptr;
+	if(i >= timepoints.size()) {
+		in.fail();
+		return nullptr;
+	}
+	return timepoints[i];
+}
+
+//******************************************************************************
+shared_ptr<Material> ParserFromSession::read_material() {
+	auto const i = read<uint32_t>();
+	if(i == session::none)
+		return nullptr;
+	if(i >= materials.size()) {
+		in.fail();
+		return nullptr;
+	}
+	return materials[i];
+}
+
+//******************************************************************************
+template<typename T>
+void ParserFromSession::add_entity(shared_ptr<T> const& entity) {
+	entities.push_back(entity);
+	if constexpr(derived_from<T, IOriginator>)
+		state_readers.emplace_back([this, entity] { read_states(*entity); });
+}
+
+// Each state is read into a copy of the state the Originator was built with,
+// then all of them replace its states. The initial and current Timepoints must
+// be among them.
+//******************************************************************************
+template<typename State>
+void ParserFromSession::read_states(Originator<State>& originator) {
+	vector<pair<Timepoint*, remove_const_t<State>>> states;
+	auto const size = read<size_t>();
+	for(size_t i = 0; i < size && !in.has_failed(); ++i) {
+		auto* const t = read_timepoint();
+		remove_const_t<State> state = originator.get_current_state();
+		apply([this](auto const&... fields) {
+			((const_cast<remove_cvref_t<decltype(fields)>&>(fields) = read<remove_cvref_t<decltype(fields)>>()), ...);
+		}, session::fields(as_const(state)));
+		if(!t)
+			in.fail();
+		states.emplace_back(t, std::move(state));
+	}
+
+	auto* const current = read_timepoint();
+	auto const has_state_at = [&states](Timepoint const* t) {
+		return ranges::any_of(states, [t](auto const& state) { return state.first == t; });
+	};
+	if(in.has_failed() || !has_state_at(originator.get_init_timepoint()) || !has_state_at(current)) {
+		in.fail();
+		return;
+	}
+	originator.restore(std::move(states), current);
+}
+
+//******************************************************************************
+expected<ParserFromSession::Output, string> ParserFromSession::parse() {
+	auto& caretaker = Caretaker::singleton();
+
+	auto magic = session::magic;
+	in.read(magic);
+	if(magic != session::magic)
+		return unexpected("Not an OpenEMSH session");
+	if(read<uint32_t>() != session::version)
+		return unexpected("Unsupported session version");
+	if(read<uint32_t>() != session::byte_order)
+		return unexpected("Unsupported byte order");
+	Output output { .board = nullptr, .input = read<string>() };
+	output.database_unit = read<double>();
+
+	// Timepoints, under the history root of the Caretaker.
+	auto const timepoint_count = read<size_t>();
+	if(!timepoint_count)
+		return unexpected("No history");
+	timepoints.push_back(caretaker.get_history_root());
+	for(size_t i = 1; i < timepoint_count && !in.has_failed(); ++i) {
+		auto const parent = read<uint32_t>();
+		if(parent >= i)
+			return unexpected("Timepoint before its parent");
+		timepoints.push_back(&timepoints[parent]->add_child());
+	}
+
+	// Caretaker history, applied last.
+	auto* const current = read_timepoint();
+	auto const read_timepoints = [this] {
+		vector<Timepoint*> ts;
+		auto const size = read<size_t>();
+		for(size_t i = 0; i < size && !in.has_failed(); ++i)
+			ts.push_back(read_timepoint());
+		return ts;
+	};
+	auto const user_history = read_timepoints();
+	auto const user_history_browser = read<optional<size_t>>();
+	auto pinned = read_timepoints();
+
+	map<Timepoint*, unique_ptr<IAnnotation>> annotations;
+	auto const annotation_count = read<size_t>();
+	for(size_t i = 0; i < annotation_count && !in.has_failed(); ++i) {
+		auto* const t = read_timepoint();
+		auto const bytes = read<vector<byte>>();
+		if(!t || !read_annotation)
+			continue;
+		BinaryReader annotation_in(bytes);
+		if(auto annotation = read_annotation(annotation_in); annotation && !annotation_in.has_failed())
+			annotations.emplace(t, std::move(annotation));
+	}
+
+	auto const material_count = read<size_t>();
+	for(size_t i = 0; i < material_count && !in.has_failed(); ++i) {
+		auto const type = read<Material::Type>();
+		auto const name = read<string>();
+		auto const fill_color = read<optional<Material::Color>>();
+		auto const edge_color = read<optional<Material::Color>>();
+		materials.push_back(make_shared<Material>(type, name, fill_color, edge_color));
+	}
+
+	auto const record_count = read<size_t>();
+	for(size_t i = 0; i < record_count && !in.has_failed(); ++i)
+		TRY(parse_record());
+	if(in.has_failed() || !board)
+		return unexpected("Truncated or corrupted records");
+
+	read_states(*board);
+	read_states(*board->global_params);
+	read_states(board->get_conflict_manager());
+	read_states(board->get_meshline_policy_manager());
+	for(auto const& read_entity_states : state_readers)
+		read_entity_states();
+	if(in.has_failed() || !in.empty() || !current)
+		return unexpected("Truncated or corrupted states");
+
+	caretaker.restore(current, user_history, user_history_browser, std::move(pinned), std::move(annotations));
+	for(auto const& originator : to_take_care_of)
+		caretaker.take_care_of(originator);
+
+	output.board = board;
+	return output;
+}
+
+// Entities that their manager registers to the Caretaker are registered once
+// all states are restored. Meshlines are not Originators, so without Timepoint.
+//******************************************************************************
+expected<void, string> ParserFromSession::parse_record() {
+	auto const kind = read<session::Kind>();
+	auto* const t = kind != session::Kind::MESHLINE ? read_timepoint() : nullptr;
+	if(in.has_failed() || (!t && kind != session::Kind::MESHLINE))
+		return unexpected("Entity without initial timepoint");
+	if(kind != session::Kind::POLYGON && kind != session::Kind::BOARD && !board)
+		return unexpected("Entity before the board");
+
+	switch(kind) {
+	case session::Kind::POLYGON: {
+		auto const plane = read<Plane>();
+		auto const name = read<string>();
+		auto const priority = read<size_t>();
+		auto const z_min = read<Coord>();
+		auto const z_max = read<Coord>();
+		auto const material = read_material();
+		vector<unique_ptr<Point const>> points;
+		auto const point_count = read<size_t>();
+		for(size_t i = 0; i < point_count && !in.has_failed(); ++i)
+			points.push_back(make_unique<Point const>(read<Point>()));
+		if(in.has_failed())
+			return unexpected("Truncated polygon");
+		// Registers its edges itself.
+		auto const polygon = make_shared<Polygon>(plane, material, name, priority, Polygon::RangeZ(z_min, z_max), std::move(points), t);
+		add_entity(polygon);
+		for(auto const& edge : polygon->edges)
+			add_entity(edge);
+		break;
+	}
+	case session::Kind::BOARD: {
+		if(board)
+			return unexpected("Several boards");
+		auto material = read_material();
+		auto fixed_meshline_policy_coords = read<AxisSpace<vector<Coord>>>();
+		auto const init_polygons = read<PlaneSpace<PersistentVector<shared_ptr<Polygon>>>>();
+		if(in.has_failed())
+			return unexpected("Truncated board");
+		PlaneSpace<vector<shared_ptr<Polygon>>> polygons;
+		for(auto const& plane : AllPlane)
+			polygons[plane].assign(begin(init_polygons[plane]), end(init_polygons[plane]));
+		// Registers its polygons and managers itself.
+		board = make_shared<Board>(std::move(polygons), std::move(fixed_meshline_policy_coords), std::move(material), Params(), t);
+		break;
+	}
+	case session::Kind::ANGLE: {
+		auto const p = read<Point>();
+		auto* const e0 = read<Edge*>();
+		auto* const e1 = read<Edge*>();
+		add_entity(make_shared<Angle>(p, e0, e1, t));
+		break;
+	}
+	case session::Kind::MESHLINE_POLICY: {
+		auto const axis = read<Axis>();
+		auto const coord = read<Coord>();
+		auto const policy = make_shared<MeshlinePolicy>(axis, MeshlinePolicy::Policy::ONELINE, MeshlinePolicy::Normal::NONE, board->global_params.get(), coord, t);
+		add_entity(policy);
+		to_take_care_of.push_back(policy);
+		break;
+	}
+	case session::Kind::CONFLICT_COLINEAR_EDGES: {
+		auto const conflict = make_shared<ConflictColinearEdges>(read<Axis>(), vector<Edge*> {}, t);
+		add_entity(conflict);
+		to_take_care_of.push_back(conflict);
+		break;
+	}
+	case session::Kind::CONFLICT_EDGE_IN_POLYGON: {
+		auto const plane = read<Plane>();
+		auto* const edge = read<Edge*>();
+		if(!edge)
+			return unexpected("Conflict without edge");
+		auto const conflict = make_shared<ConflictEdgeInPolygon>(plane, edge, nullptr, Range(edge->p0(), edge->p1()), nullopt, t);
+		add_entity(conflict);
+		to_take_care_of.push_back(conflict);
+		break;
+	}
+	case session::Kind::CONFLICT_TOO_CLOSE_MESHLINE_POLICIES: {
+		auto const axis = read<Axis>();
+		auto* const a = read<MeshlinePolicy*>();
+		auto* const b = read<MeshlinePolicy*>();
+		auto const conflict = make_shared<ConflictTooCloseMeshlinePolicies>(axis, a, b, t);
+		add_entity(conflict);
+		to_take_care_of.push_back(conflict);
+		break;
+	}
+	case session::Kind::CONFLICT_DIAGONAL_OR_CIRCULAR_ZONE: {
+		auto const conflict = make_shared<ConflictDiagonalOrCircularZone>(read<Axis>(), vector<Angle*> {}, board->global_params.get(), t);
+		add_entity(conflict);
+		to_take_care_of.push_back(conflict);
+		break;
+	}
+	case session::Kind::INTERVAL: {
+		auto const axis = read<Axis>();
+		auto* const before = read<MeshlinePolicy*>();
+		auto* const after = read<MeshlinePolicy*>();
+		if(!before || !after)
+			return unexpected("Interval without meshline policies");
+		// Policy states are restored as they were, sides must not touch them.
+		auto const interval = make_shared<Interval>(before, after, axis, board->global_params.get(), t, false);
+		add_entity(interval);
+		to_take_care_of.push_back(interval);
+		break;
+	}
+	case session::Kind::MESHLINE: {
+		auto const coord = read<Coord>();
+		auto const* const interval = read<Interval const*>();
+		auto const* const policy = read<MeshlinePolicy const*>();
+		add_entity(make_shared<Meshline>(coord, interval, policy));
+		break;
+	}
+	default:
+		return unexpected("Unknown entity");
+	}
+	return {};
+}
@@ -0,0 +1,71 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utils/binary_io.hpp"
+#include "utils/entity.hpp"
+#include "utils/state_management.hpp"
+
+namespace domain {
+
+class Board;
+class Material;
+
+} // namespace domain
+
+/// Restore a session saved by SerializerToSession, into the Caretaker
+/// singleton, that should have been reset before. Entities are built again
+/// from their records, then all their states are overwritten, so their ids
+/// differ from the saved ones. Annotations are user defined, so read by
+/// read_annotation.
+///*****************************************************************************
+class ParserFromSession {
+public:
+	using AnnotationReader = std::function<std::unique_ptr<IAnnotation> (BinaryReader& in)>;
+
+	struct Output {
+		std::shared_ptr<domain::Board> board;
+		std::filesystem::path input; ///< Of the saved session.
+		double database_unit = 0; ///< Fixed-point mode the saved geometry was snapped with.
+	};
+
+	[[nodiscard]] static std::expected<Output, std::string> run(std::filesystem::path const& session, AnnotationReader const& read_annotation);
+
+private:
+	ParserFromSession(std::vector<std::byte> const& bytes, AnnotationReader const& read_annotation);
+
+	std::expected<Output, std::string> parse();
+	std::expected<void, std::string> parse_record();
+
+	template<typename T>
+	T read();
+	Timepoint* read_timepoint();
+	std::shared_ptr<domain::Material> read_material();
+	template<typename T>
+	void add_entity(std::shared_ptr<T> const& entity);
+	template<typename State>
+	void read_states(Originator<State>& originator);
+
+	BinaryReader in;
+	AnnotationReader const& read_annotation;
+
+	std::shared_ptr<domain::Board> board;
+	std::vector<std::shared_ptr<Entity>> entities;
+	std::vector<Timepoint*> timepoints;
+	std::vector<std::shared_ptr<domain::Material>> materials;
+	std::vector<std::function<void ()>> state_readers; // In entities order.
+	std::vector<std::shared_ptr<IOriginator>> to_take_care_of;
+};
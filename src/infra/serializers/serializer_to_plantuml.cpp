@@ -65,7 +65,8 @@ void SerializerToPlantuml::visit(Board& board) {
 		for(auto const axis : AllAxis) {
 			out += "state \"Axis " + to_string(axis) + "\" as " + to_string(axis) + " {\n";
 
-			auto policies = board.get_meshline_policies(axis);
+			auto const& all_policies = board.get_meshline_policies(axis);
+			vector<shared_ptr<MeshlinePolicy>> policies(begin(all_policies), end(all_policies));
 
 			ranges::sort(policies,
 				[](auto const& a, auto const& b) {
@@ -63,7 +63,8 @@ void SerializerToPrettyprint::visit(Board& board) {
 			conflict->accept(*this);
 
 	for(auto const axis : AllAxis) {
-		auto policies = board.get_meshline_policies(axis);
+		auto const& all_policies = board.get_meshline_policies(axis);
+		vector<shared_ptr<MeshlinePolicy>> policies(begin(all_policies), end(all_policies));
 
 		ranges::sort(policies,
 			[](auto const& a, auto const& b) {
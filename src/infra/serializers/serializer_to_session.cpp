@@ -0,0 +1,333 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <unordered_set>
+
+#include "domain/mesh/meshline.hpp"
+#include "infra/utils/session_format.hpp"
+#include "utils/concepts.hpp"
+
+#include "serializer_to_session.hpp"
+
+using namespace domain;
+using namespace std;
+
+//******************************************************************************
+expected<void, string> SerializerToSession::run(
+		Board& board,
+		filesystem::path const& input,
+		filesystem::path const& output,
+		AnnotationWriter const& write_annotation) {
+
+	SerializerToSession serializer(input, write_annotation);
+	board.accept(serializer);
+
+	auto const& bytes = serializer.out.get_bytes();
+	ofstream file(output, ios::binary | ios::trunc);
+	file.write(reinterpret_cast<char const*>(bytes.data()), (streamsize) bytes.size());
+	if(!file)
+		return unexpected(format("Failed to write file \"{}\"", output.generic_string()));
+	return {};
+}
+
+//******************************************************************************
+SerializerToSession::SerializerToSession(filesystem::path const& input, AnnotationWriter const& write_annotation)
+: input(input)
+, write_annotation(write_annotation)
+{}
+
+// Entities are written as their index, and Range through its points, as
+// neither can be read back from raw bytes.
+//******************************************************************************
+template<typename T>
+void SerializerToSession::write(T const& value) {
+	if constexpr(IsOptional<T>::value) {
+		write(value.has_value());
+		if(value)
+			write(*value);
+	} else if constexpr(PointerLike<T>) {
+		auto const* const address = to_address(value);
+		auto const it = address
+			? entities.find(dynamic_cast<void const*>(address))
+			: end(entities);
+		write(it != end(entities) ? it->second : session::none);
+	} else if constexpr(IsPairOrTuple<T>::value) {
+		apply([this](auto const&... items) { write_all(items...); }, value);
+	} else if constexpr(same_as<T, string>) {
+		out.write(value);
+	} else if constexpr(same_as<T, Range>) {
+		write_all(value.p0(), value.p1());
+	} else if constexpr(ranges::sized_range<T>) {
+		write(ranges::size(value));
+		for(auto const& item : value)
+			write(item);
+	} else {
+		out.write(value);
+	}
+}
+
+//******************************************************************************
+void SerializerToSession::write_timepoint(Timepoint const* t) {
+	auto const it = timepoints.find(t);
+	write(it != end(timepoints) ? it->second : session::none);
+}
+
+//******************************************************************************
+void SerializerToSession::write_material(Material const* material) {
+	auto const it = materials.find(material);
+	write(it != end(materials) ? it->second : session::none);
+}
+
+//******************************************************************************
+template<typename T>
+void SerializerToSession::add_entity(T& entity) {
+	entities.emplace(dynamic_cast<void const*>(&entity), (uint32_t) entities.size());
+	state_writers.emplace_back([this, &entity] { write_states(entity); });
+}
+
+// In insertion order, then the current Timepoint.
+//******************************************************************************
+template<typename State>
+void SerializerToSession::write_states(Originator<State> const& originator) {
+	auto const states = originator.get_available_states();
+	write(states.size());
+	for(auto const& [t, state] : states) {
+		write_timepoint(t);
+		apply([this](auto const&... fields) { write_all(fields...); }, session::fields(state));
+	}
+	write_timepoint(originator.get_current_timepoint());
+}
+
+//******************************************************************************
+void SerializerToSession::visit(Board& board) {
+	auto& caretaker = Caretaker::singleton();
+
+	out.write(session::magic);
+	write_all(session::version, session::byte_order);
+	write(input.generic_string());
+	write(domain::database_unit);
+
+	// Timepoints in creation order, so parents come first.
+	vector<Timepoint*> all_timepoints;
+	for(auto* t : caretaker.get_history_root()->descendants(true))
+		all_timepoints.push_back(t);
+	ranges::sort(all_timepoints, [](Timepoint const* a, Timepoint const* b) {
+		return a->id < b->id;
+	});
+	for(auto const* t : all_timepoints)
+		timepoints.emplace(t, (uint32_t) timepoints.size());
+
+	write(all_timepoints.size());
+	for(auto const* t : all_timepoints | views::drop(1))
+		write_timepoint(t->parent());
+
+	write_timepoint(caretaker.get_current_timepoint());
+	auto const user_history = caretaker.get_user_history();
+	write(user_history.size());
+	for(auto const* t : user_history)
+		write_timepoint(t);
+	write(caretaker.get_user_history_browser());
+	auto const pinned = caretaker.get_pinned_timepoints();
+	write(pinned.size());
+	for(auto const* t : pinned)
+		write_timepoint(t);
+
+	auto const& annotations = caretaker.get_annotations();
+	write(write_annotation ? annotations.size() : size_t(0));
+	if(write_annotation) {
+		for(auto const& [t, annotation] : annotations) {
+			BinaryWriter annotation_out;
+			write_annotation(*annotation, annotation_out);
+			write_timepoint(t);
+			write(annotation_out.get_bytes());
+		}
+	}
+
+	// Every entity found in any state, once, in order of appearance.
+	unordered_set<void const*> seen;
+	auto const collect = [&seen]<typename T>(vector<shared_ptr<T>>& found, auto const& items) {
+		for(auto const& item : items)
+			if(seen.insert(item.get()).second)
+				found.push_back(item);
+	};
+
+	vector<shared_ptr<Polygon>> polygons;
+	vector<shared_ptr<Angle>> angles;
+	for(auto const& [_, state] : board.get_available_states()) {
+		for(auto const& plane : AllPlane) {
+			collect(polygons, state.polygons[plane]);
+			collect(angles, state.angles[plane]);
+		}
+	}
+
+	vector<shared_ptr<MeshlinePolicy>> policies;
+	vector<shared_ptr<Interval>> intervals;
+	vector<shared_ptr<Meshline>> meshlines;
+	for(auto const& [_, state] : board.get_meshline_policy_manager().get_available_states()) {
+		for(auto const& axis : AllAxis) {
+			collect(policies, state.line_policies[axis]);
+			collect(intervals, state.intervals[axis]);
+			collect(meshlines, state.meshlines[axis]);
+		}
+	}
+
+	vector<shared_ptr<ConflictColinearEdges>> colinear_edges;
+	vector<shared_ptr<ConflictEdgeInPolygon>> edge_in_polygons;
+	vector<shared_ptr<ConflictTooCloseMeshlinePolicies>> too_close_meshline_policies;
+	vector<shared_ptr<ConflictDiagonalOrCircularZone>> diagonal_or_circular_zones;
+	for(auto const& [_, state] : board.get_conflict_manager().get_available_states()) {
+		for(auto const& plane : AllPlane)
+			collect(edge_in_polygons, state.all_edge_in_polygons[plane]);
+		for(auto const& axis : AllAxis) {
+			collect(colinear_edges, state.all_colinear_edges[axis]);
+			collect(too_close_meshline_policies, state.all_too_close_meshline_policies[axis]);
+			collect(diagonal_or_circular_zones, state.all_diagonal_or_circular_zone[axis]);
+		}
+	}
+
+	vector<Material const*> all_materials;
+	auto const add_material = [&](Material const* material) {
+		if(material && materials.emplace(material, (uint32_t) materials.size()).second)
+			all_materials.push_back(material);
+	};
+	add_material(board.material.get());
+	for(auto const& polygon : polygons)
+		add_material(polygon->material.get());
+
+	write(all_materials.size());
+	for(auto const* material : all_materials)
+		write_all(material->type, material->name, material->fill_color, material->edge_color);
+
+	// Records, each entity after the ones it is built from.
+	write(polygons.size() + 1 + angles.size() + policies.size()
+		+ colinear_edges.size() + edge_in_polygons.size()
+		+ too_close_meshline_policies.size() + diagonal_or_circular_zones.size()
+		+ intervals.size() + meshlines.size());
+
+	for(auto const& polygon : polygons)
+		polygon->accept(*this);
+
+	write(session::Kind::BOARD);
+	write_timepoint(board.get_init_timepoint());
+	write_material(board.material.get());
+	write(board.fixed_meshline_policy_coords);
+	for(auto const& [t, state] : board.get_available_states())
+		if(t == board.get_init_timepoint())
+			write(state.polygons);
+
+	for(auto const& angle : angles)
+		angle->accept(*this);
+	for(auto const& policy : policies)
+		policy->accept(*this);
+	for(auto const& conflict : colinear_edges)
+		conflict->accept(*this);
+	for(auto const& conflict : edge_in_polygons)
+		conflict->accept(*this);
+	for(auto const& conflict : too_close_meshline_policies)
+		conflict->accept(*this);
+	for(auto const& conflict : diagonal_or_circular_zones)
+		conflict->accept(*this);
+	for(auto const& interval : intervals)
+		interval->accept(*this);
+	for(auto const& meshline : meshlines)
+		meshline->accept(*this);
+
+	// States, of the Board and its managers first.
+	write_states(board);
+	write_states(*board.global_params);
+	write_states(board.get_conflict_manager());
+	write_states(board.get_meshline_policy_manager());
+	for(auto const& write_entity_states : state_writers)
+		write_entity_states();
+}
+
+// Followed by its edges, that it builds itself.
+//******************************************************************************
+void SerializerToSession::visit(Polygon& polygon) {
+	write(session::Kind::POLYGON);
+	write_timepoint(polygon.get_init_timepoint());
+	write_all(polygon.plane, polygon.name, polygon.priority, polygon.z_placement.min, polygon.z_placement.max);
+	write_material(polygon.material.get());
+	write(polygon.points.size());
+	for(auto const& point : polygon.points)
+		write(*point);
+
+	add_entity(polygon);
+	for(auto const& edge : polygon.edges)
+		add_entity(*edge);
+}
+
+//******************************************************************************
+void SerializerToSession::visit(Angle& angle) {
+	write(session::Kind::ANGLE);
+	write_timepoint(angle.get_init_timepoint());
+	write_all(angle.p, angle.e0, angle.e1);
+	add_entity(angle);
+}
+
+//******************************************************************************
+void SerializerToSession::visit(MeshlinePolicy& policy) {
+	write(session::Kind::MESHLINE_POLICY);
+	write_timepoint(policy.get_init_timepoint());
+	write_all(policy.axis, policy.coord);
+	add_entity(policy);
+}
+
+//******************************************************************************
+void SerializerToSession::visit(ConflictColinearEdges& conflict) {
+	write(session::Kind::CONFLICT_COLINEAR_EDGES);
+	write_timepoint(conflict.get_init_timepoint());
+	write(conflict.axis);
+	add_entity(conflict);
+}
+
+//******************************************************************************
+void SerializerToSession::visit(ConflictEdgeInPolygon& conflict) {
+	write(session::Kind::CONFLICT_EDGE_IN_POLYGON);
+	write_timepoint(conflict.get_init_timepoint());
+	write_all(conflict.plane, conflict.edge);
+	add_entity(conflict);
+}
+
+//******************************************************************************
+void SerializerToSession::visit(ConflictTooCloseMeshlinePolicies& conflict) {
+	write(session::Kind::CONFLICT_TOO_CLOSE_MESHLINE_POLICIES);
+	write_timepoint(conflict.get_init_timepoint());
+	write_all(conflict.axis, conflict.meshline_policies[0], conflict.meshline_policies[1]);
+	add_entity(conflict);
+}
+
+//******************************************************************************
+void SerializerToSession::visit(ConflictDiagonalOrCircularZone& conflict) {
+	write(session::Kind::CONFLICT_DIAGONAL_OR_CIRCULAR_ZONE);
+	write_timepoint(conflict.get_init_timepoint());
+	write(conflict.axis);
+	add_entity(conflict);
+}
+
+// Sides policies are the same in every state.
+//******************************************************************************
+void SerializerToSession::visit(Interval& interval) {
+	auto const& state = interval.get_current_state();
+	write(session::Kind::INTERVAL);
+	write_timepoint(interval.get_init_timepoint());
+	write_all(interval.axis, state.before.meshline_policy, state.after.meshline_policy);
+	add_entity(interval);
+}
+
+// Not an Originator, so without states.
+//******************************************************************************
+void SerializerToSession::visit(Meshline& meshline) {
+	write(session::Kind::MESHLINE);
+	write_all(meshline.coord, meshline.interval, meshline.policy);
+	entities.emplace(dynamic_cast<void const*>(&meshline), (uint32_t) entities.size());
+}
@@ -0,0 +1,74 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "domain/utils/entity_visitor.hpp"
+#include "utils/binary_io.hpp"
+#include "utils/state_management.hpp"
+
+namespace domain {
+
+class Material;
+
+} // namespace domain
+
+/// Save the whole meshing session : the Caretaker history and every
+/// Originator with all its states, to be restored by ParserFromSession without
+/// meshing again. Annotations are user defined, so written by write_annotation.
+///*****************************************************************************
+class SerializerToSession final : public domain::EntityVisitor {
+public:
+	using AnnotationWriter = std::function<void (IAnnotation const& annotation, BinaryWriter& out)>;
+
+	static std::expected<void, std::string> run(
+		domain::Board& board,
+		std::filesystem::path const& input,
+		std::filesystem::path const& output,
+		AnnotationWriter const& write_annotation);
+
+private:
+	void visit(domain::Board& board) override;
+	void visit(domain::Polygon& polygon) override;
+	void visit(domain::Angle& angle) override;
+	void visit(domain::MeshlinePolicy& policy) override;
+	void visit(domain::ConflictColinearEdges& conflict) override;
+	void visit(domain::ConflictEdgeInPolygon& conflict) override;
+	void visit(domain::ConflictTooCloseMeshlinePolicies& conflict) override;
+	void visit(domain::ConflictDiagonalOrCircularZone& conflict) override;
+	void visit(domain::Interval& interval) override;
+	void visit(domain::Meshline& meshline) override;
+
+	SerializerToSession(std::filesystem::path const& input, AnnotationWriter const& write_annotation);
+
+	template<typename T>
+	void write(T const& value);
+	template<typename... T>
+	void write_all(T const&... values) { (write(values), ...); }
+	void write_timepoint(Timepoint const* t);
+	void write_material(domain::Material const* material);
+	template<typename T>
+	void add_entity(T& entity);
+	template<typename State>
+	void write_states(Originator<State> const& originator);
+
+	std::filesystem::path const input;
+	AnnotationWriter const& write_annotation;
+
+	BinaryWriter out;
+	std::unordered_map<void const*, std::uint32_t> entities; // By most derived address.
+	std::unordered_map<Timepoint const*, std::uint32_t> timepoints;
+	std::unordered_map<domain::Material const*, std::uint32_t> materials;
+	std::vector<std::function<void ()>> state_writers; // In entities order.
+};
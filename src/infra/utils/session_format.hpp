@@ -0,0 +1,95 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+
+#include "domain/conflicts/conflict_colinear_edges.hpp"
+#include "domain/conflicts/conflict_diagonal_or_circular_zone.hpp"
+#include "domain/conflicts/conflict_edge_in_polygon.hpp"
+#include "domain/conflicts/conflict_too_close_meshline_policies.hpp"
+#include "domain/geometrics/angle.hpp"
+#include "domain/geometrics/edge.hpp"
+#include "domain/geometrics/polygon.hpp"
+#include "domain/mesh/interval.hpp"
+#include "domain/mesh/meshline_policy.hpp"
+#include "domain/board.hpp"
+#include "domain/conflict_manager.hpp"
+#include "domain/global.hpp"
+#include "domain/meshline_policy_manager.hpp"
+#include "utils/state_management.hpp"
+
+/// Layout shared by SerializerToSession and ParserFromSession, in this order :
+/// header, input path, database unit, Timepoints tree, Caretaker history, materials, entity
+/// records, then the states of every Originator.
+///
+/// Entities and Timepoints are referred to by their index in their table, in
+/// creation order. Records only refer to previous entities, so they can be
+/// built in a single pass, while states may refer to any of them.
+///*****************************************************************************
+namespace session {
+
+inline constexpr std::array<char, 8> magic { 'O', 'E', 'M', 'S', 'H', 'S', 'E', 'S' };
+inline constexpr std::uint32_t version = 2;
+inline constexpr std::uint32_t byte_order = 0x01020304;
+inline constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max(); ///< Index of nullptr.
+
+//******************************************************************************
+enum class Kind : std::uint8_t {
+	POLYGON, ///< Followed by its edges.
+	BOARD, ///< After all polygons, not an index.
+	ANGLE,
+	MESHLINE_POLICY,
+	CONFLICT_COLINEAR_EDGES,
+	CONFLICT_EDGE_IN_POLYGON,
+	CONFLICT_TOO_CLOSE_MESHLINE_POLICIES,
+	CONFLICT_DIAGONAL_OR_CIRCULAR_ZONE,
+	INTERVAL,
+	MESHLINE
+};
+
+/// Saved fields of each state, read back into a copy of the state its
+/// Originator was built with, so the fields that never change once built, like
+/// Interval::Side functions, are not saved.
+///*****************************************************************************
+template<Spillable State>
+auto fields(State const& state) {
+	return spill_fields(state);
+}
+
+//******************************************************************************
+inline auto fields(domain::BoardState const& state) {
+	return std::tie(state.polygons, state.edges, state.angles);
+}
+
+//******************************************************************************
+inline auto fields(domain::ConflictManagerState const& state) {
+	return std::tie(state.all_edge_in_polygons, state.all_colinear_edges, state.all_too_close_meshline_policies, state.all_diagonal_or_circular_zone);
+}
+
+//******************************************************************************
+inline auto fields(domain::MeshlinePolicyManagerState const& state) {
+	return std::tie(state.line_policies, state.meshlines, state.intervals);
+}
+
+//******************************************************************************
+inline auto fields(domain::ConflictEdgeInPolygonState const& state) {
+	return std::tie(state.meshline_policy, state.is_solved, state.solution, state.overlaps);
+}
+
+//******************************************************************************
+inline auto fields(domain::IntervalState const& state) {
+	return std::tie(
+		state.conflicts, state.dmax,
+		state.before.lmin, state.before.smoothness, state.before.ls, state.before.smoothness_iterations,
+		state.after.lmin, state.after.smoothness, state.after.ls, state.after.smoothness_iterations);
+}
+
+} // namespace session
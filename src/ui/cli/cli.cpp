@@ -132,6 +132,9 @@ app::OpenEMSH::Params cli(int const argc, char* argv[]) {
 //	app.add_option("-o,--output", params.output, "Output CSX file. If different from input, will copy and extend it.")->check(CLI::Validator((!CLI::ExistingFile)|FutureConditional(params.force,"Cannot overwrite a file without --force"), "FILE", "KO"));
 	app.add_option("-o,--output", params.output, "Output CSX file. If different from input, will copy and extend it. (Defaults to input, if provided)")->type_name(format("{}:FILE", CLI::detail::type_name<decltype(params.output)>()));
 	app.add_flag("-f,--force", params.force, "Allow overwriting a file.")->trigger_on_parse();
+	app.add_option("-j,--jobs", params.jobs, "Mesh all axes on N threads, with the same result as serial mode.")->check(CLI::PositiveNumber)->default_str(to_string(params.jobs));
+	app.add_flag("--history", params.history, "Keep states history, as in GUI mode. Slower and more memory hungry in batch mode.");
+	app.add_option("--spill-history", params.spill_history, "Keep states of the last N undo steps in memory, spill older ones to a temporary file. 0 keeps all in memory. Only per entity states are spilled, states of the board and its managers always stay in memory.")->default_str(to_string(params.spill_history));
 
 	static std::map<std::string, app::OpenEMSH::Params::OutputFormat, std::less<>> const output_formats {
 		{ "csx", app::OpenEMSH::Params::OutputFormat::CSX },
@@ -146,6 +149,7 @@ app::OpenEMSH::Params cli(int const argc, char* argv[]) {
 	app.add_flag("--no-xy", [&params](size_t) { params.with_xy = false; }, "Don't process XY plane.")->group("Input options");
 	app.add_option("--read-oemsh-params", params.read_oemsh_params, "Read OpenEMSH parameters from file, if any.")->group("Input options")->default_str(to_string(params.read_oemsh_params));
 	app.add_option("--integrate-old-mesh", params.keep_old_mesh, "Keep current meshlines and integrate those in the final mesh.")->group("Input options")->default_str(to_string(params.keep_old_mesh));
+	app.add_option("--resolution", params.resolution, "Snap geometry to this grid, in meters, and group colinear edges by grid units. Suits Manhattan layouts. 0 keeps floating-point coordinates.")->group("Input options")->check(CLI::NonNegativeNumber)->default_str(to_string(params.resolution));
 
 	static std::map<std::string, domain::Axis, std::less<>> const axes {
 		{ "x", domain::Axis::X },
@@ -38,13 +38,13 @@ protected:
 	static bool try_to_double(QString const& in, double& out);
 	static bool try_to_ulong(QString const& in, std::size_t& out);
 	static bool try_to_bool(Qt::CheckState const in, bool& out);
+	static void set_uneditable(QStandardItem* item);
 
 private:
 	template<Enum E>
 	static void set_content(QStandardItem* item, E e);
 	static void set_content(QStandardItem* item, QString const& s);
 	static void set_content(QStandardItem* item, bool b);
-	static void set_uneditable(QStandardItem* item);
 
 signals:
 	void edit_from(app::Step from, std::function<void ()> const& edit);
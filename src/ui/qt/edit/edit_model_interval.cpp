@@ -20,7 +20,7 @@ EditModelInterval::EditModelInterval(domain::Interval* interval, QObject* parent
 , interval(interval)
 {
 	auto const& state = interval->get_current_state();
-	setRowCount(5);
+	setRowCount(7);
 
 	make_row(0, "dmax", QString::number(state.dmax),
 		"Maximum distance between two adjacent lines.");
@@ -36,6 +36,12 @@ EditModelInterval::EditModelInterval(domain::Interval* interval, QObject* parent
 	make_row(4, "After.Smoothness", QString::number(state.after.smoothness), QString("2"),
 		"Smoothness factor <b>]1;2]</b> around the maximal side. "
 		"Meshing algorithm will decrease it, better to start high.");
+	make_row(5, "Before.Smoothness iterations", QString::number(state.before.smoothness_iterations),
+		"Iterations taken by the meshing algorithm to decrease the smoothness factor around the minimal side.");
+	make_row(6, "After.Smoothness iterations", QString::number(state.after.smoothness_iterations),
+		"Iterations taken by the meshing algorithm to decrease the smoothness factor around the maximal side.");
+	set_uneditable(item(5, V));
+	set_uneditable(item(6, V));
 }
 
 //******************************************************************************
@@ -356,6 +356,7 @@ void MainWindow::on_tb_processing_zoom_out_clicked() {
 
 //******************************************************************************
 static QString const format_filter_csx("OpenEMS CSX file (*.csx *.xml)");
+static QString const format_filter_session("OpenEMSH session (*.oemsh)");
 
 //******************************************************************************
 void MainWindow::on_a_file_open_triggered() {
@@ -461,6 +462,79 @@ void MainWindow::on_a_file_save_as_triggered() {
 	}
 }
 
+// The session input becomes the CSX file, so saving writes the mesh there.
+//******************************************************************************
+void MainWindow::on_a_session_open_triggered() {
+	QFileDialog dialog(this, ui->a_session_open->text());
+	dialog.setAcceptMode(QFileDialog::AcceptOpen);
+	dialog.setFileMode(QFileDialog::ExistingFile);
+	dialog.setNameFilter(format_filter_session);
+	dialog.setDirectory(csx_file.isEmpty() ? QString(".") : QFileInfo(csx_file).path());
+	if(dialog.exec()) {
+		auto const session_file = dialog.selectedFiles().first();
+
+		clear();
+		QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+		if(auto res = oemsh.open_session(session_file.toStdString())
+		; !res.has_value()) {
+			QGuiApplication::restoreOverrideCursor();
+			update_board_dependant_buttons_visibility(false);
+			log({
+				.level = Logger::Level::ERROR,
+				.user_actions = { Logger::UserAction::OK },
+				.message = std::format(
+					"Failed to open session \"{}\" : {}",
+					session_file.toStdString(),
+					res.error())
+				});
+			return;
+		}
+
+		csx_file = QString::fromStdString(oemsh.get_params().input.generic_string());
+		update_board_dependant_buttons_visibility(true);
+		update_title();
+		ui->structure_view->init(&oemsh.get_board());
+		ui->processing_view->init(&oemsh.get_board());
+		make_current_state_view();
+		QGuiApplication::restoreOverrideCursor();
+		on_a_fit_triggered();
+	}
+}
+
+//******************************************************************************
+void MainWindow::on_a_session_save_as_triggered() {
+	QFileDialog dialog(this, ui->a_session_save_as->text());
+	dialog.setAcceptMode(QFileDialog::AcceptSave);
+	dialog.setFileMode(QFileDialog::AnyFile);
+	dialog.setNameFilter(format_filter_session);
+	dialog.setDefaultSuffix(".oemsh");
+	dialog.setDirectory(csx_file.isEmpty() ? QString(".") : QFileInfo(csx_file).path());
+	if(dialog.exec()) {
+		auto const session_file = dialog.selectedFiles().first();
+
+		QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+		if(auto res = oemsh.save_session(session_file.toStdString())
+		; res.has_value()) {
+			log({
+				.level = Logger::Level::INFO,
+				.message = std::format(
+					"Saved session \"{}\"",
+					session_file.toStdString())
+				});
+		} else {
+			log({
+				.level = Logger::Level::ERROR,
+				.user_actions = { Logger::UserAction::OK },
+				.message = std::format(
+					"Failed to save session \"{}\" : {}",
+					session_file.toStdString(),
+					res.error())
+				});
+		}
+		QGuiApplication::restoreOverrideCursor();
+	}
+}
+
 //******************************************************************************
 void MainWindow::on_a_appcsxcad_triggered() {
 	auto* file = new QTemporaryFile(this);
@@ -657,6 +731,7 @@ void MainWindow::handle_edition_from(app::Step from, std::function<void ()> cons
 void MainWindow::update_board_dependant_buttons_visibility(bool are_enabled) {
 	ui->a_file_save->setEnabled(are_enabled);
 	ui->a_file_save_as->setEnabled(are_enabled);
+	ui->a_session_save_as->setEnabled(are_enabled);
 	ui->a_edit->setEnabled(are_enabled);
 	ui->a_mesh_prev->setEnabled(are_enabled);
 	ui->a_mesh_next->setEnabled(are_enabled);
@@ -76,6 +76,8 @@ private slots:
 	void on_a_file_open_triggered();
 	void on_a_file_save_triggered();
 	void on_a_file_save_as_triggered();
+	void on_a_session_open_triggered();
+	void on_a_session_save_as_triggered();
 	void on_a_edit_triggered();
 	void on_a_mesh_prev_triggered();
 	void on_a_mesh_next_triggered();
@@ -0,0 +1,134 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Raw binary encoding in native byte order, for data read back by the same
+/// build. Pointers are written as addresses.
+///
+/// Supports trivially copyable types, strings, vectors, pairs, tuples and
+/// optionals of supported types.
+///*****************************************************************************
+class BinaryWriter {
+private:
+	std::vector<std::byte> bytes;
+
+public:
+	std::vector<std::byte> const& get_bytes() const noexcept { return bytes; }
+
+	template<typename T>
+	void write(T const& value);
+	template<typename... T>
+	void write_all(T const&... values) { (write(values), ...); }
+};
+
+/// Counterpart of BinaryWriter, reading into existing values.
+///
+/// Reading past the end, or a size larger than the remaining bytes, leaves the
+/// value unchanged and the reader failed, so truncated input is detected.
+///*****************************************************************************
+class BinaryReader {
+private:
+	std::span<std::byte const> bytes;
+	bool failed = false;
+
+public:
+	explicit BinaryReader(std::span<std::byte const> bytes) noexcept : bytes(bytes) {}
+
+	bool empty() const noexcept { return bytes.empty(); }
+	bool has_failed() const noexcept { return failed; }
+	void fail() noexcept { failed = true; bytes = {}; }
+
+	template<typename T>
+	void read(T& value);
+	template<typename... T>
+	void read_all(T&... values) { (read(values), ...); }
+};
+
+//******************************************************************************
+template<typename T>
+struct IsPairOrTuple : std::false_type {};
+template<typename A, typename B>
+struct IsPairOrTuple<std::pair<A, B>> : std::true_type {};
+template<typename... T>
+struct IsPairOrTuple<std::tuple<T...>> : std::true_type {};
+
+//******************************************************************************
+template<typename T>
+struct IsVectorOrString : std::false_type {};
+template<typename T>
+struct IsVectorOrString<std::vector<T>> : std::true_type {};
+template<typename T>
+struct IsVectorOrString<std::basic_string<T>> : std::true_type {};
+
+//******************************************************************************
+template<typename T>
+struct IsOptional : std::false_type {};
+template<typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+//******************************************************************************
+template<typename T>
+void BinaryWriter::write(T const& value) {
+	if constexpr(IsPairOrTuple<T>::value) {
+		std::apply([this](auto const&... items) { (write(items), ...); }, value);
+	} else if constexpr(IsVectorOrString<T>::value) {
+		write(value.size());
+		for(auto const& item : value)
+			write(item);
+	} else if constexpr(IsOptional<T>::value) {
+		write(value.has_value());
+		if(value)
+			write(*value);
+	} else {
+		static_assert(std::is_trivially_copyable_v<T>, "Unsupported type");
+		auto const* const begin = reinterpret_cast<std::byte const*>(&value);
+		bytes.insert(std::end(bytes), begin, begin + sizeof(T));
+	}
+}
+
+//******************************************************************************
+template<typename T>
+void BinaryReader::read(T& value) {
+	if constexpr(IsPairOrTuple<T>::value) {
+		std::apply([this](auto&... items) { (read(items), ...); }, value);
+	} else if constexpr(IsVectorOrString<T>::value) {
+		std::size_t size = 0;
+		read(size);
+		if(size > bytes.size()) {
+			fail();
+			return;
+		}
+		value.resize(size);
+		for(auto& item : value)
+			read(item);
+	} else if constexpr(IsOptional<T>::value) {
+		bool has_value = false;
+		read(has_value);
+		if(has_value)
+			read(value.emplace());
+		else
+			value.reset();
+	} else {
+		static_assert(std::is_trivially_copyable_v<T>, "Unsupported type");
+		if(bytes.size() < sizeof(T)) {
+			fail();
+			return;
+		}
+		std::memcpy(&value, bytes.data(), sizeof(T));
+		bytes = bytes.subspan(sizeof(T));
+	}
+}
@@ -6,22 +6,24 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 
 //******************************************************************************
 inline std::size_t generate_id() {
-	static std::size_t i = 0;
-	return i++;
+	static std::atomic<std::size_t> i = 0;
+	return i.fetch_add(1, std::memory_order_relaxed);
 }
 
+// Thread safe, ids are unique but their order across threads is unspecified.
 //******************************************************************************
 class IdGenerator {
 private:
-	std::size_t i = 0;
+	std::atomic<std::size_t> i = 0;
 
 public:
 	std::size_t generate_id() {
-		return i++;
+		return i.fetch_add(1, std::memory_order_relaxed);
 	}
 
 	std::size_t operator()() {
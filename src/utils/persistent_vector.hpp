@@ -0,0 +1,209 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/// Vector whose copies share their structure, meant for Originator states : a
+/// copy costs O(1) and modifying it only copies the O(log n) nodes on the path
+/// to the modified element, the other ones staying shared with the original.
+///
+/// Elements are stored in a trie of nodes of up to width children, leaves
+/// holding the elements. A node only owned by one PersistentVector is modified
+/// in place.
+///
+/// Elements are only accessible as const, use set() to replace one.
+///*****************************************************************************
+template<typename T>
+class PersistentVector {
+private:
+	static std::size_t constexpr bits = 5;
+	static std::size_t constexpr width = 1 << bits;
+	static std::size_t constexpr mask = width - 1;
+
+	//**************************************************************************
+	struct Node {
+		std::vector<std::shared_ptr<Node>> children; // Branch only.
+		std::vector<T> values;                       // Leaf only.
+	};
+
+	std::shared_ptr<Node> root;
+	std::size_t count = 0;
+	std::size_t shift = 0; // Levels above leaves * bits.
+
+	static Node* writable(std::shared_ptr<Node>& node);
+	T const* leaf(std::size_t i) const noexcept;
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T const&;
+	using const_reference = T const&;
+
+	//**************************************************************************
+	class const_iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T const*;
+		using reference = T const&;
+
+		const_iterator() = default;
+		const_iterator(PersistentVector const* vector, std::size_t i) noexcept : vector(vector), i(i) {}
+
+		reference operator*() const noexcept;
+		pointer operator->() const noexcept { return &**this; }
+		reference operator[](difference_type n) const noexcept { return (*vector)[i + n]; }
+
+		const_iterator& operator++() noexcept { ++i; return *this; }
+		const_iterator operator++(int) noexcept { auto it = *this; ++i; return it; }
+		const_iterator& operator--() noexcept { --i; return *this; }
+		const_iterator operator--(int) noexcept { auto it = *this; --i; return it; }
+		const_iterator& operator+=(difference_type n) noexcept { i += n; return *this; }
+		const_iterator& operator-=(difference_type n) noexcept { i -= n; return *this; }
+		friend const_iterator operator+(const_iterator it, difference_type n) noexcept { return it += n; }
+		friend const_iterator operator+(difference_type n, const_iterator it) noexcept { return it += n; }
+		friend const_iterator operator-(const_iterator it, difference_type n) noexcept { return it -= n; }
+		friend difference_type operator-(const_iterator const& a, const_iterator const& b) noexcept { return difference_type(a.i) - difference_type(b.i); }
+		friend bool operator==(const_iterator const& a, const_iterator const& b) noexcept { return a.i == b.i; }
+		friend auto operator<=>(const_iterator const& a, const_iterator const& b) noexcept { return a.i <=> b.i; }
+
+	private:
+		PersistentVector const* vector = nullptr;
+		std::size_t i = 0;
+		mutable T const* block = nullptr; // Leaf holding i, cached.
+		mutable std::size_t block_i = 0;
+	};
+
+	using iterator = const_iterator;
+
+	PersistentVector() = default;
+	PersistentVector(std::initializer_list<T> values);
+	explicit PersistentVector(std::vector<T> values);
+
+	std::size_t size() const noexcept { return count; }
+	bool empty() const noexcept { return !count; }
+
+	T const& operator[](std::size_t i) const noexcept { return leaf(i)[i & mask]; }
+	T const& front() const noexcept { return (*this)[0]; }
+	T const& back() const noexcept { return (*this)[count - 1]; }
+
+	const_iterator begin() const noexcept { return { this, 0 }; }
+	const_iterator end() const noexcept { return { this, count }; }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	void push_back(T value);
+	template<typename... Args>
+	T const& emplace_back(Args&&... args);
+	void set(std::size_t i, T value);
+	void clear() noexcept;
+
+	friend bool operator==(PersistentVector const& a, PersistentVector const& b) {
+		return a.size() == b.size() && std::ranges::equal(a, b);
+	}
+};
+
+//******************************************************************************
+template<typename T>
+PersistentVector<T>::PersistentVector(std::initializer_list<T> values) {
+	for(auto const& value : values)
+		push_back(value);
+}
+
+//******************************************************************************
+template<typename T>
+PersistentVector<T>::PersistentVector(std::vector<T> values) {
+	for(auto& value : values)
+		push_back(std::move(value));
+}
+
+/// Copy node if it is shared with another PersistentVector.
+///*****************************************************************************
+template<typename T>
+typename PersistentVector<T>::Node* PersistentVector<T>::writable(std::shared_ptr<Node>& node) {
+	if(node.use_count() > 1)
+		node = std::make_shared<Node>(*node);
+	return node.get();
+}
+
+//******************************************************************************
+template<typename T>
+T const* PersistentVector<T>::leaf(std::size_t i) const noexcept {
+	Node const* node = root.get();
+	for(std::size_t level = shift; level > 0; level -= bits)
+		node = node->children[(i >> level) & mask].get();
+	return node->values.data();
+}
+
+//******************************************************************************
+template<typename T>
+void PersistentVector<T>::push_back(T value) {
+	if(!root) {
+		root = std::make_shared<Node>();
+	} else if(count == (width << shift)) {
+		auto new_root = std::make_shared<Node>();
+		new_root->children.push_back(std::move(root));
+		root = std::move(new_root);
+		shift += bits;
+	}
+
+	Node* node = writable(root);
+	for(std::size_t level = shift; level > 0; level -= bits) {
+		std::size_t const j = (count >> level) & mask;
+		if(j == node->children.size())
+			node->children.push_back(std::make_shared<Node>());
+		node = writable(node->children[j]);
+	}
+
+	node->values.push_back(std::move(value));
+	++count;
+}
+
+//******************************************************************************
+template<typename T>
+template<typename... Args>
+T const& PersistentVector<T>::emplace_back(Args&&... args) {
+	push_back(T(std::forward<Args>(args)...));
+	return back();
+}
+
+//******************************************************************************
+template<typename T>
+void PersistentVector<T>::set(std::size_t i, T value) {
+	Node* node = writable(root);
+	for(std::size_t level = shift; level > 0; level -= bits)
+		node = writable(node->children[(i >> level) & mask]);
+	node->values[i & mask] = std::move(value);
+}
+
+//******************************************************************************
+template<typename T>
+void PersistentVector<T>::clear() noexcept {
+	root.reset();
+	count = 0;
+	shift = 0;
+}
+
+//******************************************************************************
+template<typename T>
+typename PersistentVector<T>::const_iterator::reference PersistentVector<T>::const_iterator::operator*() const noexcept {
+	if(!block || block_i != (i >> bits)) {
+		block = vector->leaf(i);
+		block_i = i >> bits;
+	}
+	return block[i & mask];
+}
@@ -0,0 +1,69 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include "spill_store.hpp"
+
+using namespace std;
+
+// Offsets may go past 2 GiB, beyond what fseek() takes on some platforms.
+//******************************************************************************
+static bool seek(FILE* file, size_t offset) noexcept {
+#ifdef _WIN32
+	return !_fseeki64(file, (__int64) offset, SEEK_SET);
+#else
+	return !fseeko(file, (off_t) offset, SEEK_SET);
+#endif // _WIN32
+}
+
+//******************************************************************************
+SpillStore::SpillStore() noexcept
+: file(tmpfile(), &fclose)
+{}
+
+//******************************************************************************
+bool SpillStore::is_open() const noexcept {
+	return file != nullptr;
+}
+
+//******************************************************************************
+size_t SpillStore::size() const noexcept {
+	lock_guard const lock(mutex);
+	return end;
+}
+
+// nullopt if the store could not be written, eg. the disk is full.
+//******************************************************************************
+optional<SpillStore::Handle> SpillStore::write(span<byte const> bytes) noexcept {
+	lock_guard const lock(mutex);
+	if(!file
+	|| !seek(file.get(), end)
+	|| fwrite(bytes.data(), 1, bytes.size(), file.get()) != bytes.size())
+		return nullopt;
+
+	Handle const handle { end, bytes.size() };
+	end += bytes.size();
+	return handle;
+}
+
+// nullopt if the block could not be read back whole, eg. after clear().
+//******************************************************************************
+optional<vector<byte>> SpillStore::read(Handle const& handle) const noexcept {
+	lock_guard const lock(mutex);
+	vector<byte> bytes(handle.size);
+	if(!file
+	|| handle.offset + handle.size > end
+	|| !seek(file.get(), handle.offset)
+	|| fread(bytes.data(), 1, bytes.size(), file.get()) != bytes.size())
+		return nullopt;
+	return bytes;
+}
+
+// Invalidates all handles.
+//******************************************************************************
+void SpillStore::clear() noexcept {
+	lock_guard const lock(mutex);
+	end = 0;
+}
@@ -0,0 +1,42 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+/// Append-only store of byte blocks in an anonymous temporary file, deleted
+/// when closed. Blocks are only read back on demand, so they do not count in
+/// resident memory. Thread safe.
+///*****************************************************************************
+class SpillStore {
+public:
+	//**************************************************************************
+	struct Handle {
+		std::size_t offset = 0;
+		std::size_t size = 0;
+	};
+
+	SpillStore() noexcept;
+
+	bool is_open() const noexcept;
+	std::size_t size() const noexcept;
+
+	std::optional<Handle> write(std::span<std::byte const> bytes) noexcept;
+	std::optional<std::vector<std::byte>> read(Handle const& handle) const noexcept;
+	void clear() noexcept;
+
+private:
+	mutable std::mutex mutex;
+	std::unique_ptr<std::FILE, int (*)(std::FILE*)> file;
+	std::size_t end = 0;
+};
@@ -5,13 +5,32 @@
 ///*****************************************************************************
 
 #include <cstdlib>
-#include <execution>
 #include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "logger.hpp"
 
 #include "state_management.hpp"
 
 using namespace std;
 
+//******************************************************************************
+void abort_on_unreadable_spill() noexcept {
+	log({
+		.destination = 0,
+		.level = Logger::Level::ERROR,
+		.user_actions = {},
+		.default_user_action = nullopt,
+		.message = "Could not read back a state spilled to disk, history is corrupted.",
+		.informative = {},
+		.details = {} });
+	abort();
+}
+
 //******************************************************************************
 Caretaker& Caretaker::singleton() noexcept {
 	static Caretaker c;
@@ -28,52 +47,71 @@ Caretaker::Caretaker() noexcept
 
 //******************************************************************************
 void Caretaker::reset() noexcept {
-	current_timepoint = history_root.get();
-	pinned_timepoints.clear();
-	user_history.erase(next(begin(user_history)), end(user_history));
-	user_history_browser.reset();
-	originators.clear();
+	{
+		lock_guard const lock(mutex);
+		current_timepoint = history_root.get();
+		pinned_timepoints.clear();
+		user_history.erase(next(begin(user_history)), end(user_history));
+		user_history_browser.reset();
+		originators.clear();
+		if(spill_store) // Previous Originators keep the previous one.
+			spill_store = make_shared<SpillStore>();
+	}
 	garbage_collector();
 }
 
+// Timepoints ids follow their creation order, so both the mark and the
+// collected Timepoints are bitsets indexed by id. Only kept Timepoints and
+// collected ones are visited, and Originators are not : they erase their own
+// states lazily, when they see a new gc_generation.
 //******************************************************************************
 void Caretaker::garbage_collector() noexcept {
-	// Step 1: fill a set with all pinned/visited/current + ancestors : to keep.
-	set<Timepoint*> to_keep;
-	auto const keep = [&](auto const& list) {
-		for(auto* t : list) {
-			auto ancestors = t->ancestors(true);
-			to_keep.insert(begin(ancestors), end(ancestors));
+	if(!get_keep_history())
+		return;
+
+	lock_guard const lock(mutex);
+	size_t const first_id = history_root->id;
+
+	// Step 1: mark all pinned/visited/current + ancestors : to keep.
+	// Climbing stops at the first already kept ancestor.
+	vector<bool> is_kept;
+	auto const keep = [&](Timepoint* t) {
+		for(auto* ancestor : t->up(true)) {
+			size_t const i = ancestor->id - first_id;
+			if(i >= is_kept.size())
+				is_kept.resize(i + 1);
+			else if(is_kept[i])
+				break;
+			is_kept[i] = true;
 		}
 	};
-	keep(pinned_timepoints);
-	keep(user_history);
-	keep(array { current_timepoint });
-//	// TODO C++26 std::ranges::concat_view & C++23 unsupported yet feature std::set::insert_range()
-//	for(auto* t : ranges::concat_view(pinned_timepoints, user_history, { current_timepoint }))
-//		to_keep.insert_range(t->ancestors(true));
-
-	// Step 2: retrieve all nodes that are not to keep : to remove.
-	set<Timepoint*> to_remove;
-	ranges::copy_if(history_root->cluster(), inserter(to_remove, end(to_remove)), [&](auto* item) {
-		return !to_keep.contains(item);
-	});
-
-	// Step 3: for each originator, erase blacklisted nodes.
-	for_each(execution::unseq, begin(originators), end(originators), [&](auto const& ptr) {
-		if(auto originator = ptr.lock(); originator)
-			originator->erase(to_remove);
-	});
-
-	// Step 4: erase annotations related to blacklisted nodes.
-	erase_if(annotations, [&](auto const& item) {
-		return to_remove.contains(item.first);
-	});
+	for(auto* t : pinned_timepoints)
+		keep(t);
+	for(auto* t : user_history)
+		keep(t);
+	keep(current_timepoint);
+
+	// Step 2: remove other nodes from history tree, their annotations and
+	// mark them as collected.
+	bool has_collected = false;
+	history_root->prune(
+		[&](Timepoint const& t) {
+			size_t const i = t.id - first_id;
+			return i < is_kept.size() && is_kept[i];
+		},
+		[&](Timepoint& t) {
+			size_t const i = t.id - first_id;
+			if(i >= collected_timepoints.size())
+				collected_timepoints.resize(i + 1);
+			collected_timepoints[i] = true;
+			annotations.erase(&t);
+			has_collected = true;
+		});
 
-	// Step 5: actually remove nodes from history tree.
-	history_root->erase_from_descendants(to_remove);
+	if(has_collected)
+		++gc_generation;
 
-	// Step 6: gc expired originators.
+	// Step 3: gc expired originators.
 	erase_if(originators, [](auto const& item) {
 		return item.expired();
 	});
@@ -81,40 +119,54 @@ void Caretaker::garbage_collector() noexcept {
 
 //******************************************************************************
 void Caretaker::stop_browsing_user_history() noexcept {
+	unique_lock lock(mutex);
 	if(user_history_browser.has_value()) {
 		// Erase from browser iterator to end.
 		user_history.erase(user_history_browser->base(), user_history.end());
 		user_history_browser = nullopt;
 
-		if(auto_gc)
+		if(auto_gc) {
+			lock.unlock();
 			garbage_collector();
+		}
 	}
 }
 
 //******************************************************************************
 Timepoint* Caretaker::get_history_root() noexcept {
+	lock_guard const lock(mutex);
 	return history_root.get();
 }
 
 //******************************************************************************
 Timepoint* Caretaker::get_current_timepoint() noexcept {
+	lock_guard const lock(mutex);
 	return current_timepoint;
 }
 
 //******************************************************************************
-vector<Timepoint*> const& Caretaker::get_pinned_timepoints() const noexcept {
+vector<Timepoint*> Caretaker::get_pinned_timepoints() const noexcept {
+	lock_guard const lock(mutex);
 	return pinned_timepoints;
 }
 
 //******************************************************************************
 Timepoint* Caretaker::make_next_timepoint() noexcept {
+	if(!get_keep_history())
+		return get_current_timepoint();
+
 	stop_browsing_user_history();
+	lock_guard const lock(mutex);
 	current_timepoint = &current_timepoint->add_child();
 	return current_timepoint;
 }
 
 //******************************************************************************
 void Caretaker::take_care_of(shared_ptr<IOriginator> const& originator) noexcept {
+	if(!get_keep_history())
+		return;
+
+	lock_guard const lock(mutex);
 	// TODO Are all those checks really useful?
 	if(originator
 	&& &originator->get_caretaker() == this
@@ -125,6 +177,7 @@ void Caretaker::take_care_of(shared_ptr<IOriginator> const& originator) noexcept
 
 //******************************************************************************
 void Caretaker::undo(size_t remembered_timepoints) noexcept {
+	unique_lock lock(mutex);
 	if(!remembered_timepoints || !can_undo(remembered_timepoints))
 		return;
 
@@ -140,11 +193,13 @@ void Caretaker::undo(size_t remembered_timepoints) noexcept {
 	if(*user_history_browser == user_history.rbegin())
 		user_history_browser = nullopt;
 
+	lock.unlock();
 	go_without_remembering(current_timepoint);
 }
 
 //******************************************************************************
 void Caretaker::redo(size_t remembered_timepoints) noexcept {
+	unique_lock lock(mutex);
 	if(!remembered_timepoints || !can_redo(remembered_timepoints))
 		return;
 
@@ -154,6 +209,7 @@ void Caretaker::redo(size_t remembered_timepoints) noexcept {
 	if(*user_history_browser == user_history.rbegin())
 		user_history_browser = nullopt;
 
+	lock.unlock();
 	go_without_remembering(current_timepoint);
 }
 
@@ -161,6 +217,8 @@ void Caretaker::redo(size_t remembered_timepoints) noexcept {
 bool Caretaker::can_undo(size_t remembered_timepoints) const noexcept {
 	using It = decltype(user_history)::const_reverse_iterator;
 
+	lock_guard const lock(mutex);
+
 	if(!remembered_timepoints)
 		return false;
 	else if(user_history_browser.has_value())
@@ -177,6 +235,8 @@ bool Caretaker::can_undo(size_t remembered_timepoints) const noexcept {
 bool Caretaker::can_redo(size_t remembered_timepoints) const noexcept {
 	using It = decltype(user_history)::const_reverse_iterator;
 
+	lock_guard const lock(mutex);
+
 	if(!remembered_timepoints)
 		return false;
 	else if(user_history_browser.has_value())
@@ -188,13 +248,17 @@ bool Caretaker::can_redo(size_t remembered_timepoints) const noexcept {
 
 //******************************************************************************
 void Caretaker::unpin(Timepoint* t) noexcept {
+	unique_lock lock(mutex);
 	erase(pinned_timepoints, t);
-	if(auto_gc)
+	if(auto_gc) {
+		lock.unlock();
 		garbage_collector();
+	}
 }
 
 //******************************************************************************
 void Caretaker::pin_current_timepoint() noexcept {
+	lock_guard const lock(mutex);
 	if(ranges::none_of(pinned_timepoints,
 		[this](auto const* item) {
 			return item == current_timepoint;
@@ -205,18 +269,49 @@ void Caretaker::pin_current_timepoint() noexcept {
 
 //******************************************************************************
 void Caretaker::remember_current_timepoint() noexcept {
-	if(user_history.back() != current_timepoint)
+	unique_lock lock(mutex);
+	if(user_history.back() != current_timepoint) {
 		user_history.emplace_back(current_timepoint);
+		if(spill_threshold && user_history.size() > spill_threshold) {
+			lock.unlock();
+			spill_old_history();
+		}
+	}
+}
+
+// States older than the spill_threshold-th last remembered Timepoint are
+// spilled by their Originators, current states excepted.
+//******************************************************************************
+void Caretaker::spill_old_history() noexcept {
+	unique_lock lock(mutex);
+	if(!spill_threshold || user_history.size() <= spill_threshold)
+		return;
+
+	size_t const before_id = (*prev(end(user_history), (ptrdiff_t) spill_threshold))->id;
+	auto const store = spill_store;
+	vector<shared_ptr<IOriginator>> alive_originators;
+	for(auto const& ptr : originators)
+		if(auto originator = ptr.lock(); originator)
+			alive_originators.push_back(std::move(originator));
+
+	lock.unlock();
+	for(auto const& originator : alive_originators)
+		originator->spill(before_id, store);
 }
 
 //******************************************************************************
 bool Caretaker::go_without_remembering(Timepoint* t) noexcept {
+	unique_lock lock(mutex);
 	if(t && t->root() == history_root.get()) {
 		current_timepoint = t;
-		for_each(execution::unseq, begin(originators), end(originators), [&](auto const& ptr) {
+		vector<shared_ptr<IOriginator>> alive_originators;
+		for(auto const& ptr : originators)
 			if(auto originator = ptr.lock(); originator)
-				originator->go(t);
-		});
+				alive_originators.push_back(std::move(originator));
+
+		lock.unlock();
+		for(auto const& originator : alive_originators)
+			originator->go(t);
 		return true;
 	} else {
 		return false;
@@ -231,13 +326,19 @@ bool Caretaker::go_and_remember(Timepoint* t) noexcept {
 	return does_succeed;
 }
 
+// Without history, the single Timepoint annotation is overwritten.
 //******************************************************************************
 void Caretaker::annotate_current_timepoint(unique_ptr<IAnnotation> annotation) noexcept {
-	annotations.emplace(current_timepoint, std::move(annotation));
+	lock_guard const lock(mutex);
+	if(get_keep_history())
+		annotations.emplace(current_timepoint, std::move(annotation));
+	else
+		annotations.insert_or_assign(current_timepoint, std::move(annotation));
 }
 
 //******************************************************************************
 IAnnotation* Caretaker::get_annotation(Timepoint* t) noexcept {
+	lock_guard const lock(mutex);
 	if(annotations.contains(t))
 		return annotations.at(t).get();
 	else
@@ -253,10 +354,102 @@ Timepoint* Caretaker::find_first_ancestor_with_annotation(bool include_itself) n
 
 //******************************************************************************
 bool Caretaker::get_auto_gc() const noexcept {
+	lock_guard const lock(mutex);
 	return auto_gc;
 }
 
 //******************************************************************************
 void Caretaker::set_auto_gc(bool _auto_gc) noexcept {
+	lock_guard const lock(mutex);
 	auto_gc = _auto_gc;
 }
+
+//******************************************************************************
+bool Caretaker::get_keep_history() const noexcept {
+	return keep_history.load(memory_order_acquire);
+}
+
+// To switch before making any state, eg. right after reset(), as Timepoints
+// made meanwhile are neither collected nor navigable.
+//******************************************************************************
+void Caretaker::set_keep_history(bool _keep_history) noexcept {
+	keep_history.store(_keep_history, memory_order_release);
+}
+
+//******************************************************************************
+size_t Caretaker::get_spill_threshold() const noexcept {
+	lock_guard const lock(mutex);
+	return spill_threshold;
+}
+
+// Keep states of the last remembered_timepoints user history entries in
+// memory, 0 to never spill. Falls back to 0 if no temporary file can be made.
+// Only Spillable states are concerned, see the Caretaker comment.
+//******************************************************************************
+void Caretaker::set_spill_threshold(size_t remembered_timepoints) noexcept {
+	lock_guard const lock(mutex);
+	if(remembered_timepoints && !spill_store)
+		if(auto store = make_shared<SpillStore>(); store->is_open())
+			spill_store = std::move(store);
+	spill_threshold = spill_store ? remembered_timepoints : 0;
+}
+
+//******************************************************************************
+size_t Caretaker::get_gc_generation() const noexcept {
+	return gc_generation.load(memory_order_acquire);
+}
+
+// Timepoints of other histories are never collected by this Caretaker.
+//******************************************************************************
+bool Caretaker::is_collected(size_t id) const noexcept {
+	lock_guard const lock(mutex);
+	size_t const first_id = history_root->id;
+	return id >= first_id
+	    && id - first_id < collected_timepoints.size()
+	    && collected_timepoints[id - first_id];
+}
+
+//******************************************************************************
+vector<Timepoint*> Caretaker::get_user_history() const noexcept {
+	lock_guard const lock(mutex);
+	return { begin(user_history), end(user_history) };
+}
+
+// Position of the browsed Timepoint in get_user_history(), if browsing.
+//******************************************************************************
+optional<size_t> Caretaker::get_user_history_browser() const noexcept {
+	lock_guard const lock(mutex);
+	if(!user_history_browser)
+		return nullopt;
+	return (size_t) distance(cbegin(user_history), decltype(user_history)::const_iterator(user_history_browser->base())) - 1;
+}
+
+//******************************************************************************
+map<Timepoint*, unique_ptr<IAnnotation>> const& Caretaker::get_annotations() const noexcept {
+	lock_guard const lock(mutex);
+	return annotations;
+}
+
+// Counterpart of the getters above, eg. when loading a session into a history
+// tree rebuilt from the root. Originators are expected to be restored
+// separately, at current.
+//******************************************************************************
+void Caretaker::restore(
+		Timepoint* current,
+		vector<Timepoint*> const& _user_history,
+		optional<size_t> _user_history_browser,
+		vector<Timepoint*> pinned,
+		map<Timepoint*, unique_ptr<IAnnotation>>&& _annotations) noexcept {
+	lock_guard const lock(mutex);
+	current_timepoint = current;
+	pinned_timepoints = std::move(pinned);
+	annotations = std::move(_annotations);
+
+	user_history.assign(begin(_user_history), end(_user_history));
+	if(user_history.empty() || user_history.front() != history_root.get())
+		user_history.push_front(history_root.get());
+
+	user_history_browser.reset();
+	if(_user_history_browser && *_user_history_browser + 1 < user_history.size())
+		user_history_browser = make_reverse_iterator(next(begin(user_history), (ptrdiff_t) *_user_history_browser + 1));
+}
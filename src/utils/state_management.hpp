@@ -7,17 +7,26 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <functional>
+#include <limits>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
 #include <set>
+#include <span>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "binary_io.hpp"
 #include "concepts.hpp"
+#include "spill_store.hpp"
 #include "tree_node.hpp"
 #include "unconst.hpp"
 
@@ -25,6 +34,21 @@ using Timepoint = TreeNode;
 
 class IOriginator;
 
+/// States that can be spilled to disk with old history provide, findable by
+/// ADL, a spill_fields(State const&) returning a std::tie() of their fields.
+/// Fields must be supported by BinaryWriter and must not own anything, as
+/// pointers are spilled as addresses.
+///*****************************************************************************
+template<typename State>
+concept Spillable = requires(std::remove_const_t<State> const& state) {
+	spill_fields(state);
+};
+
+/// Logs that a state spilled to disk could not be read back, then aborts, as
+/// the history is corrupted.
+///*****************************************************************************
+[[noreturn]] void abort_on_unreadable_spill() noexcept;
+
 #ifdef UNITTEST
 #define private public
 #define protected public
@@ -39,10 +63,38 @@ public:
 // Annotation and history/pining are orthogonal, annotation is for user to attach
 // user defined data to timepoints while history take a role in undo/redo navigation
 // and both history and pinning prevent from garbage collection.
+//
+// Thread safety : Caretaker and Originators can be used from several threads.
+// Timepoints are allocated under the Caretaker lock, so they form a single
+// chain whatever the thread. The Caretaker never waits for an Originator while
+// holding its own lock, so an Originator may be locked during a whole
+// read-modify-write sequence (see Originator::lock()) even if it asks for new
+// timepoints meanwhile. Navigating the history (undo, redo, go) while other
+// threads are making states is not supported.
+//
+// Each state is allocated on its own, so a reference from get_current_state()
+// survives states made later, whatever the thread. It dies with the state
+// itself : garbage collection, spill, or replacement at the same Timepoint
+// (always the case without history). Readers that may race such a replacement
+// must hold Originator::lock() or take a share_current_state() snapshot.
+//
+// States at Timepoints older than the last remembered ones may be spilled to
+// disk, see set_spill_threshold(). They are read back on demand. Only Spillable
+// states are, which are the small per entity ones : states owning entities
+// (Board, managers, Intervals...) always stay in memory, so resident memory
+// still grows with history. States read back, eg. by get_available_states(),
+// stay in memory until the next spill.
+//
+// Without history (see set_keep_history()), there is a single Timepoint :
+// make_next_timepoint() returns the current one, Originators replace their
+// state in place and garbage collection has nothing to do. Meant for batch
+// runs, that never navigate.
 //******************************************************************************
 class Caretaker {
 private:
+	mutable std::recursive_mutex mutex;
 	bool auto_gc;
+	std::atomic<bool> keep_history = true;
 	std::unique_ptr<Timepoint> history_root;
 	Timepoint* current_timepoint;
 	std::vector<std::weak_ptr<IOriginator>> originators;
@@ -50,8 +102,13 @@ private:
 	std::list<Timepoint*> user_history;
 	std::optional<decltype(user_history)::reverse_iterator> user_history_browser;
 	std::map<Timepoint*, std::unique_ptr<IAnnotation>> annotations;
+	std::atomic<std::size_t> gc_generation = 0;
+	std::vector<bool> collected_timepoints; // Indexed by id - history_root id.
+	std::size_t spill_threshold = 0; // 0 : never spill.
+	std::shared_ptr<SpillStore> spill_store;
 
 	void stop_browsing_user_history() noexcept;
+	void spill_old_history() noexcept;
 
 public:
 	static Caretaker& singleton() noexcept;
@@ -60,11 +117,13 @@ public:
 	void garbage_collector() noexcept;
 
 	Caretaker() noexcept;
+	Caretaker(Caretaker const&) = delete;
+	Caretaker& operator=(Caretaker const&) = delete;
 
 	Timepoint* get_history_root() noexcept;
 	Timepoint* get_current_timepoint() noexcept;
 	Timepoint* make_next_timepoint() noexcept;
-	std::vector<Timepoint*> const& get_pinned_timepoints() const noexcept;
+	std::vector<Timepoint*> get_pinned_timepoints() const noexcept;
 
 	void take_care_of(std::shared_ptr<IOriginator> const& originator) noexcept;
 
@@ -90,6 +149,25 @@ public:
 
 	bool get_auto_gc() const noexcept;
 	void set_auto_gc(bool _auto_gc) noexcept;
+
+	bool get_keep_history() const noexcept;
+	void set_keep_history(bool _keep_history) noexcept;
+
+	std::size_t get_gc_generation() const noexcept;
+	bool is_collected(std::size_t id) const noexcept;
+
+	std::size_t get_spill_threshold() const noexcept;
+	void set_spill_threshold(std::size_t remembered_timepoints) noexcept;
+
+	std::vector<Timepoint*> get_user_history() const noexcept;
+	std::optional<std::size_t> get_user_history_browser() const noexcept;
+	std::map<Timepoint*, std::unique_ptr<IAnnotation>> const& get_annotations() const noexcept;
+	void restore(
+		Timepoint* current,
+		std::vector<Timepoint*> const& user_history,
+		std::optional<std::size_t> user_history_browser,
+		std::vector<Timepoint*> pinned,
+		std::map<Timepoint*, std::unique_ptr<IAnnotation>>&& annotations) noexcept;
 };
 
 //******************************************************************************
@@ -102,6 +180,7 @@ public:
 	virtual ~IOriginator() = default;
 	virtual void go(Timepoint* t) noexcept = 0;
 	virtual void erase(std::set<Timepoint*> const& ts) noexcept = 0;
+	virtual void spill(std::size_t before_id, std::shared_ptr<SpillStore> const& store) noexcept = 0;
 	virtual Timepoint* get_init_timepoint() const noexcept = 0;
 };
 
@@ -109,15 +188,35 @@ public:
 template<typename State>
 class Originator : public IOriginator {
 private:
+	mutable std::recursive_mutex mutex;
 	Caretaker& caretaker;
 	Timepoint* const init_timepoint;
 	Timepoint* current_timepoint;
 	std::optional<Timepoint*> lazy_go; // Here nullptr != nullopt.
-	// TODO An ordered map would fit better.
-	// TODO https://github.com/Tessil/ordered-map
-	std::map<Timepoint*, State> states; // Keep Timepoint -- State association.
-	std::vector<Timepoint*> ordered_timepoints; // Keep Timepoint insertion order.
 
+	// Timepoint id is copied so erased Timepoints are never dereferenced, and
+	// identifies it, as erased Timepoints addresses are reused.
+	// Spilled states are not resident, but may be read back. States are shared
+	// so that snapshots outlive their replacement.
+	struct Entry {
+		std::size_t id;
+		Timepoint* t;
+		std::shared_ptr<State const> state;
+		std::optional<SpillStore::Handle> spilled = std::nullopt;
+	};
+
+	std::vector<Entry> states; // Keep Timepoint -- State association, sorted by Timepoint id.
+	std::vector<Timepoint*> ordered_timepoints; // Keep Timepoint insertion order.
+	std::size_t gc_generation = 0; // Last Caretaker garbage collection caught up.
+	std::shared_ptr<SpillStore> spill_store; // Where spilled states are.
+
+	static std::size_t id_of(Timepoint const* t) noexcept;
+	typename std::vector<Entry>::const_iterator find_entry(Timepoint const* t) const noexcept;
+	State const* find_state(Timepoint const* t) const noexcept;
+	void page_in(Entry& entry) const noexcept;
+	template<typename P>
+	void erase_states_if(P const& predicate) noexcept;
+	void catch_up_garbage_collector() noexcept;
 	void actually_go() noexcept;
 
 protected:
@@ -130,13 +229,18 @@ public:
 	Timepoint* get_init_timepoint() const noexcept final;
 	Timepoint* get_current_timepoint() const noexcept;
 
+	[[nodiscard]] std::unique_lock<std::recursive_mutex> lock() const noexcept;
+
 	State const& get_current_state() const noexcept;
+	std::shared_ptr<State const> share_current_state() const noexcept;
 
 	void go(Timepoint* t) noexcept final;
 
 	void erase(std::set<Timepoint*> const& ts) noexcept final;
+	void spill(std::size_t before_id, std::shared_ptr<SpillStore> const& store) noexcept final;
 
 	std::vector<std::pair<Timepoint*, State const&>> get_available_states() const noexcept;
+	void restore(std::vector<std::pair<Timepoint*, std::remove_const_t<State>>>&& states, Timepoint* current) noexcept;
 
 	Timepoint* next_timepoint() const noexcept;
 	void set_state(Timepoint* t, State const& state) noexcept;
@@ -155,7 +259,8 @@ public:
 //******************************************************************************
 template<InvocableR<bool, IAnnotation const*> P>
 Timepoint* Caretaker::find_first_ancestor_with_annotation_that(P const& predicate, bool include_itself) noexcept {
-	for(auto* t : current_timepoint->ancestors(include_itself))
+	std::lock_guard const lock(mutex);
+	for(auto* t : current_timepoint->up(include_itself))
 		if(annotations.contains(t) && predicate(annotations.at(t).get()))
 			return t;
 	return nullptr;
@@ -167,8 +272,9 @@ Originator<State>::Originator(Timepoint* init_timepoint, State state, Caretaker&
 : caretaker(caretaker)
 , init_timepoint(init_timepoint)
 , current_timepoint(init_timepoint)
-, states{{ init_timepoint, state }}
+, states{{ id_of(init_timepoint), init_timepoint, std::make_shared<State const>(state) }}
 , ordered_timepoints{ init_timepoint }
+, gc_generation(caretaker.get_gc_generation())
 {}
 
 //******************************************************************************
@@ -177,10 +283,65 @@ Originator<State>::Originator(Timepoint* init_timepoint, Caretaker& caretaker) n
 : caretaker(caretaker)
 , init_timepoint(init_timepoint)
 , current_timepoint(init_timepoint)
-, states{{ init_timepoint, State() }}
+, states{{ id_of(init_timepoint), init_timepoint, std::make_shared<State const>() }}
 , ordered_timepoints{ init_timepoint }
+, gc_generation(caretaker.get_gc_generation())
 {}
 
+// Temporary Originators may live at nullptr, sorted after any Timepoint.
+//******************************************************************************
+template<typename State>
+std::size_t Originator<State>::id_of(Timepoint const* t) noexcept {
+	return t ? t->id : std::numeric_limits<std::size_t>::max();
+}
+
+// Timepoints ids are sequential, so states are mostly appended.
+//******************************************************************************
+template<typename State>
+typename std::vector<typename Originator<State>::Entry>::const_iterator Originator<State>::find_entry(Timepoint const* t) const noexcept {
+	std::size_t const id = id_of(t);
+	if(states.empty() || states.back().id < id)
+		return std::end(states);
+	return std::lower_bound(std::begin(states), std::end(states), id,
+		[](Entry const& entry, std::size_t id) {
+			return entry.id < id;
+		});
+}
+
+//******************************************************************************
+template<typename State>
+State const* Originator<State>::find_state(Timepoint const* t) const noexcept {
+	if(auto it = find_entry(t); it != std::end(states) && it->id == id_of(t)) {
+		if(!it->state)
+			page_in(unconst(*it));
+		return it->state.get();
+	}
+	return nullptr;
+}
+
+// Read back a spilled state, that stays resident until the next spill.
+// A state that cannot be read back whole is lost, and its fields would
+// silently be null : that is fatal.
+//******************************************************************************
+template<typename State>
+void Originator<State>::page_in(Entry& entry) const noexcept {
+	if constexpr(Spillable<State>) {
+		std::optional<std::vector<std::byte>> const bytes = spill_store->read(*entry.spilled);
+		BinaryReader in(bytes ? std::span<std::byte const>(*bytes) : std::span<std::byte const>());
+		std::remove_const_t<State> state;
+		if(bytes)
+			std::apply([&in](auto const&... fields) {
+				in.read_all(const_cast<std::remove_cvref_t<decltype(fields)>&>(fields)...);
+			}, spill_fields(std::as_const(state)));
+
+		if(!bytes || in.has_failed() || !in.empty()) {
+			abort_on_unreadable_spill();
+		}
+
+		entry.state = std::make_shared<State const>(std::move(state));
+	}
+}
+
 //******************************************************************************
 template<typename State>
 Caretaker& Originator<State>::get_caretaker() const noexcept {
@@ -196,20 +357,43 @@ Timepoint* Originator<State>::get_init_timepoint() const noexcept {
 //******************************************************************************
 template<typename State>
 Timepoint* Originator<State>::get_current_timepoint() const noexcept {
+	std::lock_guard const lock(mutex);
 	unconst(this)->actually_go();
 	return current_timepoint;
 }
 
+// The reference lives as long as the state, see Caretaker about thread safety.
 //******************************************************************************
 template<typename State>
 State const& Originator<State>::get_current_state() const noexcept {
-	return states.at(get_current_timepoint());
+	std::lock_guard const lock(mutex);
+	return *find_state(get_current_timepoint());
+}
+
+// Snapshot that stays valid even if the state gets replaced, spilled or erased
+// meanwhile, eg. by another thread.
+//******************************************************************************
+template<typename State>
+std::shared_ptr<State const> Originator<State>::share_current_state() const noexcept {
+	std::lock_guard const lock(mutex);
+	find_state(get_current_timepoint());
+	return find_entry(current_timepoint)->state;
+}
+
+// Hold it to make a read-modify-write sequence atomic regarding other threads,
+// eg. from make_next_state() to set_state(). Timepoints asked meanwhile are
+// then guaranteed to be ordered for this Originator.
+//******************************************************************************
+template<typename State>
+std::unique_lock<std::recursive_mutex> Originator<State>::lock() const noexcept {
+	return std::unique_lock(mutex);
 }
 
 // Go to t or its last ancestor. If desired timepoint is older than init_timepoint, go nullptr
 //******************************************************************************
 template<typename State>
 void Originator<State>::go(Timepoint* t) noexcept {
+	std::lock_guard const lock(mutex);
 	lazy_go = t;
 }
 
@@ -221,13 +405,13 @@ void Originator<State>::go(Timepoint* t) noexcept {
 //******************************************************************************
 template<typename State>
 void Originator<State>::actually_go() noexcept {
+	catch_up_garbage_collector();
 	if(lazy_go.has_value()) {
 		auto* const t = lazy_go.value();
 		lazy_go.reset();
 		if(t)
 			for(auto* it : std::ranges::reverse_view(ordered_timepoints)) {
-				if(auto const* common_ancestor = it->common_ancestor(*t, true)
-				; common_ancestor == it) {
+				if(it == t || it->is_ancestor_of(*t)) {
 					current_timepoint = it;
 					return;
 				}
@@ -239,33 +423,133 @@ void Originator<State>::actually_go() noexcept {
 //******************************************************************************
 template<typename State>
 void Originator<State>::erase(std::set<Timepoint*> const& ts) noexcept {
+	std::lock_guard const lock(mutex);
 	actually_go();
+	erase_states_if([&](Entry const& entry) {
+		return ts.contains(entry.t);
+	});
+}
 
-	auto const is_erasable = [&](Timepoint* t) {
-		if(t == init_timepoint || t == current_timepoint)
+// Never erase init and current states, unless current is about to change on
+// a pending go(). Only compares Timepoints addresses, as they may already be
+// destroyed.
+//******************************************************************************
+template<typename State>
+template<typename P>
+void Originator<State>::erase_states_if(P const& predicate) noexcept {
+	auto const is_erasable = [&](Entry const& entry) {
+		if(entry.t == init_timepoint || (entry.t == current_timepoint && !lazy_go.has_value()))
 			return false;
 		else
-			return ts.contains(t);
+			return predicate(entry);
 	};
 
-	std::erase_if(states, [&](auto const& item) {
-		return is_erasable(item.first);
-	});
-	std::erase_if(ordered_timepoints, [&](auto* item) {
-		return is_erasable(item);
+	if(std::ranges::none_of(states, is_erasable))
+		return;
+
+	// States may not be assignable, so kept ones are moved into a new vector.
+	std::vector<Entry> kept;
+	std::vector<Timepoint*> erased;
+	kept.reserve(states.size());
+	for(auto& entry : states) {
+		if(is_erasable(entry))
+			erased.push_back(entry.t);
+		else
+			kept.push_back(std::move(entry));
+	}
+	states = std::move(kept);
+
+	std::ranges::sort(erased);
+	std::erase_if(ordered_timepoints, [&](Timepoint* t) {
+		return std::ranges::binary_search(erased, t);
 	});
 }
 
+// The Caretaker garbage collector does not visit Originators, each of them
+// erases its states at collected Timepoints the next time it is used, before
+// dereferencing any of them.
+//******************************************************************************
+template<typename State>
+void Originator<State>::catch_up_garbage_collector() noexcept {
+	if(std::size_t const generation = caretaker.get_gc_generation()
+	; generation != gc_generation) {
+		gc_generation = generation;
+		erase_states_if([this](Entry const& entry) {
+			return caretaker.is_collected(entry.id);
+		});
+	}
+}
+
+// Spill states older than before_id, except the current one. A state already
+// spilled once is not written again, as it never changes.
+//******************************************************************************
+template<typename State>
+void Originator<State>::spill(std::size_t before_id, std::shared_ptr<SpillStore> const& store) noexcept {
+	if constexpr(Spillable<State>) {
+		std::lock_guard const lock(mutex);
+		actually_go();
+		spill_store = store;
+		for(auto& entry : states) {
+			if(entry.id >= before_id)
+				break;
+			if(!entry.state || entry.t == current_timepoint)
+				continue;
+			if(!entry.spilled) {
+				BinaryWriter out;
+				std::apply([&out](auto const&... fields) {
+					out.write_all(fields...);
+				}, spill_fields(*entry.state));
+				entry.spilled = store->write(out.get_bytes());
+				if(!entry.spilled)
+					return; // Store unavailable, keep states resident.
+			}
+			entry.state.reset();
+		}
+	}
+}
+
 //******************************************************************************
 template<typename State>
 std::vector<std::pair<Timepoint*, State const&>> Originator<State>::get_available_states() const noexcept {
+	std::lock_guard const lock(mutex);
+	unconst(this)->catch_up_garbage_collector();
 	std::vector<std::pair<Timepoint*, State const&>> ret;
 	for(std::size_t i = 0; i < ordered_timepoints.size(); i++) {
-		ret.emplace_back(ordered_timepoints[i], states.at(ordered_timepoints[i]));
+		ret.emplace_back(ordered_timepoints[i], *find_state(ordered_timepoints[i]));
 	}
 	return ret;
 }
 
+// Replace the whole history, given in insertion order as get_available_states()
+// returns it, eg. when loading a session. init_timepoint must be among them.
+//******************************************************************************
+template<typename State>
+void Originator<State>::restore(std::vector<std::pair<Timepoint*, std::remove_const_t<State>>>&& _states, Timepoint* current) noexcept {
+	std::lock_guard const lock(mutex);
+	std::vector<std::size_t> order(_states.size());
+	for(std::size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::ranges::stable_sort(order, [&](std::size_t a, std::size_t b) {
+		return id_of(_states[a].first) < id_of(_states[b].first);
+	});
+
+	// States may not be assignable, so they are moved into a new vector.
+	std::vector<Entry> restored;
+	restored.reserve(_states.size());
+	for(std::size_t const i : order)
+		restored.push_back({ id_of(_states[i].first), _states[i].first, std::make_shared<State const>(std::move(_states[i].second)) });
+	states = std::move(restored);
+
+	ordered_timepoints.clear();
+	for(auto const& [t, _] : _states)
+		ordered_timepoints.push_back(t);
+
+	current_timepoint = current;
+	lazy_go.reset();
+	gc_generation = caretaker.get_gc_generation();
+	spill_store.reset();
+}
+
 // Asks the Caretaker to create the next state and return it.
 //******************************************************************************
 template<typename State>
@@ -274,19 +558,41 @@ Timepoint* Originator<State>::next_timepoint() const noexcept {
 }
 
 // TODO Should it be allowed to update existing state?
+// Without history, it always is, that is the only way to make a new state.
 //******************************************************************************
 template<typename State>
 void Originator<State>::set_state(Timepoint* t, State const& state) noexcept {
-	if(std::ranges::none_of(ordered_timepoints, [&](auto const& it) { return it == t; })) {
+	std::lock_guard const lock(mutex);
+	catch_up_garbage_collector();
+	auto const it = find_entry(t);
+	std::size_t const i = it - std::cbegin(states);
+	if(it == std::cend(states) || it->id != id_of(t)) {
 		lazy_go.reset();
-		states.emplace(t, state);
+		if(it == std::cend(states)) {
+			states.push_back({ id_of(t), t, std::make_shared<State const>(state) });
+		} else {
+			// Older than the last state : rare, states may not be assignable.
+			std::vector<Entry> inserted;
+			inserted.reserve(states.size() + 1);
+			for(std::size_t j = 0; j < states.size(); ++j) {
+				if(j == i)
+					inserted.push_back({ id_of(t), t, std::make_shared<State const>(state) });
+				inserted.push_back(std::move(states[j]));
+			}
+			states = std::move(inserted);
+		}
 		ordered_timepoints.push_back(t);
 		current_timepoint = t;
+	} else if(!caretaker.get_keep_history()) {
+		// state may refer to the replaced one, so it is copied first.
+		states[i].state = std::make_shared<State const>(state);
+		states[i].spilled.reset();
+		lazy_go.reset();
+		current_timepoint = t;
 	} else {
 		if constexpr(!std::is_const_v<std::remove_reference_t<State>>) {
-//			states.insert_or_assign(t, state);
-			std::erase_if(states, [&](auto const& it) { return it.first == t; });
-			states.emplace(t, state);
+			states[i].state = std::make_shared<State const>(state);
+			states[i].spilled.reset();
 		}
 	}
 }
@@ -308,5 +614,6 @@ void Originator<State>::set_given_or_next_state(State const& state, Timepoint* t
 //******************************************************************************
 template<typename State>
 std::tuple<Timepoint*, std::remove_const_t<State>> Originator<State>::make_next_state() const noexcept {
+	std::lock_guard const lock(mutex);
 	return { next_timepoint(), get_current_state() };
 }
@@ -5,8 +5,10 @@
 ///*****************************************************************************
 
 #include <algorithm>
-#include <execution>
-#include <string>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
 
 #include "id_generator.hpp"
 
@@ -17,15 +19,119 @@ using namespace std;
 //******************************************************************************
 static IdGenerator id_generator;
 
+// Slots of a chunk are never moved, so TreeNodes addresses are stable. Dead
+// slots are chained in a free list, reused before growing the last chunk.
+//******************************************************************************
+class TreeNode::Arena {
+public:
+	TreeNode* make(TreeNode* parent);
+	void destroy(TreeNode* node) noexcept;
+
+private:
+	static size_t constexpr chunk_size = 256;
+
+	union Slot {
+		Slot* next_free;
+		alignas(TreeNode) byte node[sizeof(TreeNode)];
+	};
+
+	vector<unique_ptr<Slot[]>> chunks;
+	size_t last_chunk_size = chunk_size;
+	Slot* free_slots = nullptr;
+};
+
+//******************************************************************************
+TreeNode* TreeNode::Arena::make(TreeNode* parent) {
+	Slot* slot;
+	if(free_slots) {
+		slot = free_slots;
+		free_slots = slot->next_free;
+	} else {
+		if(last_chunk_size == chunk_size) {
+			chunks.push_back(make_unique_for_overwrite<Slot[]>(chunk_size));
+			last_chunk_size = 0;
+		}
+		slot = &chunks.back()[last_chunk_size++];
+	}
+	return new(slot->node) TreeNode(parent);
+}
+
+//******************************************************************************
+void TreeNode::Arena::destroy(TreeNode* node) noexcept {
+	node->~TreeNode();
+	auto* slot = reinterpret_cast<Slot*>(node);
+	slot->next_free = free_slots;
+	free_slots = slot;
+}
+
+//******************************************************************************
+TreeNode::TreeNode()
+: TreeNode(nullptr)
+{}
+
+// Jump to the jump of the parent if both jumps span the same depth, else to
+// the parent. Jump depths then only depend on depth, as skew-binary numbers.
 //******************************************************************************
 TreeNode::TreeNode(TreeNode* parent)
 : id(id_generator())
+, depth(parent ? parent->depth + 1 : 0)
+, arena(parent ? parent->arena : nullptr)
 , _parent(parent)
-{}
+, jump(this)
+{
+	if(!parent)
+		return;
+
+	if(parent->depth - parent->jump->depth == parent->jump->depth - parent->jump->jump->depth)
+		jump = parent->jump->jump;
+	else
+		jump = parent;
+}
+
+// Descendants are dropped along with the chunks : they own no resource.
+//******************************************************************************
+TreeNode::~TreeNode() = default;
 
 //******************************************************************************
 TreeNode& TreeNode::add_child() {
-	return children.emplace_back(this);
+	if(!arena) {
+		own_arena = make_unique<Arena>();
+		arena = own_arena.get();
+	}
+
+	TreeNode* child = arena->make(this);
+	child->prev_sibling = last_child;
+	if(last_child)
+		last_child->next_sibling = child;
+	else
+		first_child = child;
+	last_child = child;
+	return *child;
+}
+
+//******************************************************************************
+void TreeNode::unlink() {
+	(prev_sibling ? prev_sibling->next_sibling : _parent->first_child) = next_sibling;
+	(next_sibling ? next_sibling->prev_sibling : _parent->last_child) = prev_sibling;
+	prev_sibling = nullptr;
+	next_sibling = nullptr;
+}
+
+// Only for unlinked descendants without children.
+//******************************************************************************
+void TreeNode::release() {
+	arena->destroy(this);
+}
+
+// Next TreeNode of the subtree_root subtree in preorder, or nullptr.
+//******************************************************************************
+TreeNode* TreeNode::next_in_preorder(TreeNode const* subtree_root, bool skip_descendants) const {
+	if(!skip_descendants && first_child)
+		return first_child;
+	for(TreeNode const* node = this; node != subtree_root; node = node->_parent)
+		if(node->next_sibling)
+			return node->next_sibling;
+	return nullptr;
 }
 
 //******************************************************************************
@@ -41,74 +147,93 @@ TreeNode* TreeNode::parent() const {
 
 //******************************************************************************
 TreeNode* TreeNode::root() {
-	auto* it = this;
-	while(it->parent())
-		it = it->parent();
-	return it;
+	return ancestor(depth);
+}
+
+//******************************************************************************
+ranges::subrange<TreeNode::UpIterator, default_sentinel_t> TreeNode::up(bool include_itself) {
+	return { UpIterator(include_itself ? this : _parent), default_sentinel };
+}
+
+//******************************************************************************
+ranges::subrange<TreeNode::ChildIterator, default_sentinel_t> TreeNode::children() const {
+	return { ChildIterator(first_child), default_sentinel };
+}
+
+//******************************************************************************
+ranges::subrange<TreeNode::DescendantIterator, default_sentinel_t> TreeNode::descendants(bool include_itself) {
+	return { DescendantIterator(include_itself ? this : first_child, this), default_sentinel };
 }
 
 //******************************************************************************
 vector<TreeNode*> TreeNode::ancestors(bool include_itself) {
-	auto* it = this;
 	vector<TreeNode*> parents;
-	if(include_itself)
-		parents.push_back(it);
-	while(it->parent()) {
-		it = it->parent();
-		parents.push_back(it);
-	}
+	parents.reserve(include_itself ? depth + 1 : depth);
+	ranges::copy(up(include_itself), back_inserter(parents));
 	return parents;
 }
 
-// TODO recursive approach, can be improved if needed
 //******************************************************************************
 vector<TreeNode*> TreeNode::leafs(bool include_itself) {
-//	auto* it = this;
 	vector<TreeNode*> leafs;
-
-	if(children.empty()) {
-		if(include_itself)
-			leafs.push_back(this);
-	} else {
-		for(auto& child : children)
-			ranges::move(child.leafs(true), back_inserter(leafs));
-	}
-
+	ranges::copy_if(descendants(include_itself), back_inserter(leafs), &TreeNode::is_leaf);
 	return leafs;
 }
 
 //******************************************************************************
 void TreeNode::erase_from_descendants(set<TreeNode*> const& nodes) {
-	erase_if(children, [&](auto& node) {
-		return nodes.contains(&node);
-	});
-
-	for(auto& child : children)
-		child.erase_from_descendants(nodes);
+	prune(
+		[&](TreeNode const& node) { return !nodes.contains(const_cast<TreeNode*>(&node)); },
+		[](TreeNode const&) {});
 }
 
-// TODO recursive approach, can be improved if needed
 //******************************************************************************
 vector<TreeNode*> TreeNode::cluster(bool include_itself) {
 	vector<TreeNode*> nodes;
+	ranges::copy(descendants(include_itself), back_inserter(nodes));
+	return nodes;
+}
 
-	if(include_itself)
-		nodes.push_back(this);
-
-	for(auto& child : children)
-		ranges::move(child.cluster(true), back_inserter(nodes));
+/// n-th ancestor, itself if n is 0 or nullptr if n is greater than depth.
+/// O(log(depth)) through jump pointers.
+///*****************************************************************************
+TreeNode* TreeNode::ancestor(size_t n) const {
+	if(n > depth)
+		return nullptr;
 
-	return nodes;
+	size_t const target = depth - n;
+	auto* it = const_cast<TreeNode*>(this);
+	while(it->depth > target)
+		it = it->jump->depth >= target ? it->jump : it->_parent;
+	return it;
 }
 
+// At equal depths, jumps span equal depths : jump both while they land on
+// different TreeNodes, else step to parents. O(log(depth)).
 //******************************************************************************
 TreeNode* TreeNode::common_ancestor(TreeNode& node, bool include_themselves) {
-	for(auto* it_a : ancestors(include_themselves))
-		if(auto node_ancestors = node.ancestors(include_themselves)
-		; any_of(execution::unseq, begin(node_ancestors), end(node_ancestors), [&](auto const& it_b) { return it_a == it_b; }))
-			return it_a;
+	TreeNode* a = include_themselves ? this : _parent;
+	TreeNode* b = include_themselves ? &node : node.parent();
+	if(!a || !b)
+		return nullptr;
 
-	return nullptr;
+	if(a->depth > b->depth)
+		a = a->ancestor(a->depth - b->depth);
+	else
+		b = b->ancestor(b->depth - a->depth);
+
+	while(a != b) {
+		if(a->is_root())
+			return nullptr;
+		if(a->jump != b->jump) {
+			a = a->jump;
+			b = b->jump;
+		} else {
+			a = a->_parent;
+			b = b->_parent;
+		}
+	}
+	return a;
 }
 
 //******************************************************************************
@@ -118,13 +243,7 @@ TreeNode* common_ancestor(TreeNode& a, TreeNode& b, bool include_themselves) {
 
 //******************************************************************************
 bool TreeNode::is_descendant_of(TreeNode const& node) const {
-	auto* it = this;
-	while(it->parent()) {
-		it = it->parent();
-		if(it == &node)
-			return true;
-	}
-	return false;
+	return node.depth < depth && ancestor(depth - node.depth) == &node;
 }
 
 //******************************************************************************
@@ -139,5 +258,5 @@ bool TreeNode::is_root() const {
 
 //******************************************************************************
 bool TreeNode::is_leaf() const {
-	return children.empty();
+	return !first_child;
 }
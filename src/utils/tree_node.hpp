@@ -6,29 +6,115 @@
 
 #pragma once
 
-#include <list>
-//#include <string>
 #include <cstddef>
-//#include <iostream>
-//#include <algorithm>
-#include <vector>
+#include <iterator>
+#include <memory>
+#include <ranges>
 #include <set>
+#include <vector>
 
 #ifdef UNITTEST
 #define private public
 #endif // UNITTEST
 
+// Descendants of a root are allocated in chunks owned by the root, and linked
+// to their parent, first child and siblings, so growing the tree rarely
+// allocates and traversing it never does. Erased TreeNodes slots are reused.
 //******************************************************************************
 class TreeNode {
 public:
-	std::size_t const id;
+	std::size_t const id; ///< Sequential, following creation order.
+	std::size_t const depth; ///< Number of ancestors.
 
 private:
+	class Arena;
+
+	std::unique_ptr<Arena> own_arena; // Roots only, created with a first child.
+	Arena* arena;
 	TreeNode* _parent;
-	std::list<TreeNode> children;
+	TreeNode* jump; // Skew-binary jump pointer, for O(log(depth)) ancestor queries.
+	TreeNode* first_child = nullptr;
+	TreeNode* last_child = nullptr;
+	TreeNode* prev_sibling = nullptr;
+	TreeNode* next_sibling = nullptr;
+
+	explicit TreeNode(TreeNode* parent);
+
+	TreeNode* next_in_preorder(TreeNode const* subtree_root, bool skip_descendants = false) const;
+	void unlink();
+	void release();
+	template<typename E>
+	void erase_subtree(E const& on_erase);
 
 public:
-	explicit TreeNode(TreeNode* parent = nullptr);
+	/// Forward iterator going up from a TreeNode to its root, without allocating.
+	///*************************************************************************
+	class UpIterator {
+	public:
+		using iterator_concept = std::forward_iterator_tag;
+		using value_type = TreeNode*;
+		using difference_type = std::ptrdiff_t;
+
+		UpIterator() = default;
+		explicit UpIterator(TreeNode* node) noexcept : node(node) {}
+
+		TreeNode* operator*() const noexcept { return node; }
+		UpIterator& operator++() noexcept { node = node->parent(); return *this; }
+		UpIterator operator++(int) noexcept { auto it = *this; ++*this; return it; }
+		bool operator==(UpIterator const&) const noexcept = default;
+		bool operator==(std::default_sentinel_t) const noexcept { return !node; }
+
+	private:
+		TreeNode* node = nullptr;
+	};
+
+	/// Forward iterator over the children of a TreeNode, in insertion order.
+	///*************************************************************************
+	class ChildIterator {
+	public:
+		using iterator_concept = std::forward_iterator_tag;
+		using value_type = TreeNode*;
+		using difference_type = std::ptrdiff_t;
+
+		ChildIterator() = default;
+		explicit ChildIterator(TreeNode* node) noexcept : node(node) {}
+
+		TreeNode* operator*() const noexcept { return node; }
+		ChildIterator& operator++() noexcept { node = node->next_sibling; return *this; }
+		ChildIterator operator++(int) noexcept { auto it = *this; ++*this; return it; }
+		bool operator==(ChildIterator const&) const noexcept = default;
+		bool operator==(std::default_sentinel_t) const noexcept { return !node; }
+
+	private:
+		TreeNode* node = nullptr;
+	};
+
+	/// Forward iterator over the descendants of a TreeNode, in preorder.
+	///*************************************************************************
+	class DescendantIterator {
+	public:
+		using iterator_concept = std::forward_iterator_tag;
+		using value_type = TreeNode*;
+		using difference_type = std::ptrdiff_t;
+
+		DescendantIterator() = default;
+		DescendantIterator(TreeNode* node, TreeNode const* subtree_root) noexcept : node(node), subtree_root(subtree_root) {}
+
+		TreeNode* operator*() const noexcept { return node; }
+		DescendantIterator& operator++() noexcept { node = node->next_in_preorder(subtree_root); return *this; }
+		DescendantIterator operator++(int) noexcept { auto it = *this; ++*this; return it; }
+		bool operator==(DescendantIterator const& b) const noexcept { return node == b.node; }
+		bool operator==(std::default_sentinel_t) const noexcept { return !node; }
+
+	private:
+		TreeNode* node = nullptr;
+		TreeNode const* subtree_root = nullptr;
+	};
+
+	TreeNode();
+	~TreeNode();
+	TreeNode(TreeNode const&) = delete;
+	TreeNode& operator=(TreeNode const&) = delete;
 
 	TreeNode& add_child();
 
@@ -37,13 +123,18 @@ public:
 	TreeNode* parent() const;
 	TreeNode* root();
 
-	//TODO up_iterator
+	std::ranges::subrange<UpIterator, std::default_sentinel_t> up(bool include_itself = false);
+	std::ranges::subrange<ChildIterator, std::default_sentinel_t> children() const;
+	std::ranges::subrange<DescendantIterator, std::default_sentinel_t> descendants(bool include_itself = false);
 	std::vector<TreeNode*> ancestors(bool include_itself = false);
 	std::vector<TreeNode*> leafs(bool include_itself = false);
 	std::vector<TreeNode*> cluster(bool include_itself = false);
 
 	void erase_from_descendants(std::set<TreeNode*> const& nodes);
+	template<typename K, typename E>
+	void prune(K const& is_kept, E const& on_erase);
 
+	TreeNode* ancestor(std::size_t n) const;
 	TreeNode* common_ancestor(TreeNode& node, bool include_themselves = true);
 
 //	TreeNode* find_in_offspring(std::size_t id);
@@ -54,6 +145,44 @@ public:
 	bool is_leaf() const;
 };
 
+/// Erase descendants for which is_kept() is false, calling on_erase() on each
+/// of them and their own descendants before they are destroyed. Only kept
+/// nodes and erased ones are visited, so is_kept() must hold for every
+/// ancestor of a kept node. Iterative, whatever the depth of the tree.
+///*****************************************************************************
+template<typename K, typename E>
+void TreeNode::prune(K const& is_kept, E const& on_erase) {
+	TreeNode* node = first_child;
+	while(node) {
+		if(is_kept(*node)) {
+			node = node->next_in_preorder(this);
+		} else {
+			TreeNode* const next = node->next_in_preorder(this, true);
+			node->erase_subtree(on_erase);
+			node = next;
+		}
+	}
+}
+
+// Unlink this TreeNode, then destroy its subtree leafs first, the deepest
+// remaining leaf being reached by going down first children.
+//******************************************************************************
+template<typename E>
+void TreeNode::erase_subtree(E const& on_erase) {
+	unlink();
+	TreeNode* node = this;
+	while(node) {
+		while(node->first_child)
+			node = node->first_child;
+		TreeNode* const parent = node == this ? nullptr : node->_parent;
+		on_erase(*node);
+		if(parent)
+			node->unlink();
+		node->release();
+		node = parent;
+	}
+}
+
 #ifdef UNITTEST
 #undef private
 #endif // UNITTEST
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "concepts.hpp"
+#include "persistent_vector.hpp"
 
 //******************************************************************************
 template<PointerLike T>
@@ -25,6 +26,18 @@ std::vector<std::add_pointer_t<typename T::element_type>> create_view(std::vecto
 	return view;
 }
 
+//******************************************************************************
+template<PointerLike T>
+std::vector<std::add_pointer_t<typename T::element_type>> create_view(PersistentVector<T> const& original) noexcept {
+	std::vector<std::add_pointer_t<typename T::element_type>> view;
+	view.reserve(original.size());
+
+	for(auto const& it : original)
+		view.push_back(it.get());
+
+	return view;
+}
+
 //******************************************************************************
 template<typename T>
 std::vector<std::unique_ptr<T const>> from_init_list(std::initializer_list<T> const& original) noexcept {
@@ -43,6 +56,12 @@ bool contains(std::vector<T> const& vector, T const& value) noexcept {
 	return std::ranges::find(vector, value) != std::end(vector);
 }
 
+//******************************************************************************
+template<typename T>
+bool contains(PersistentVector<T> const& vector, T const& value) noexcept {
+	return std::ranges::find(vector, value) != std::end(vector);
+}
+
 //******************************************************************************
 template<typename T, typename P>
 bool contains_that(std::vector<T> const& vector, P&& predicate) noexcept {
@@ -50,6 +69,13 @@ bool contains_that(std::vector<T> const& vector, P&& predicate) noexcept {
 	    != std::end(vector);
 }
 
+//******************************************************************************
+template<typename T, typename P>
+bool contains_that(PersistentVector<T> const& vector, P&& predicate) noexcept {
+	return std::ranges::find_if(vector, std::forward<decltype(predicate)>(predicate))
+	    != std::end(vector);
+}
+
 // TODO T = PointerLike or reference
 //******************************************************************************
 template<typename T, typename P>
@@ -0,0 +1,103 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "domain/geometrics/edge.hpp"
+#include "domain/geometrics/segment.hpp"
+#include "domain/material.hpp"
+
+#include "domain/board.hpp"
+
+/// @test void Board::detect_diagonal_angles(Plane plane)
+/// @test void Board::detect_edges_in_polygons(Plane plane)
+/// @test relation::SegmentSegment Edge::relation_to(Edge const& edge) const noexcept
+/// @test Bounding2D const& bounding(Edge const& edge) noexcept
+///
+/// Hidden from the default run, use `openemsh_unittest "[benchmark]"` or the
+/// benchmark target.
+///*****************************************************************************
+
+using namespace domain;
+
+/// Grid of overlapping circles, made of diagonal edges only.
+///*****************************************************************************
+static PlaneSpace<std::vector<std::shared_ptr<Polygon>>> make_circles(std::size_t n, Timepoint* t) {
+	auto material = std::make_shared<Material>(Material::Type::CONDUCTOR, "");
+	PlaneSpace<std::vector<std::shared_ptr<Polygon>>> polygons;
+	for(std::size_t i = 0; i < n; ++i)
+		for(std::size_t j = 0; j < n; ++j)
+			polygons[XY].push_back(std::make_shared<Polygon>(XY, material, "", (i + j) % 2, Polygon::RangeZ { 0, 0 }, circle_to_points({ 3.0 * i, 3.0 * j }, 2), t));
+	return polygons;
+}
+
+//******************************************************************************
+TEST_CASE("Board detections", "[.][benchmark][board]") {
+	Timepoint* t = Caretaker::singleton().get_history_root();
+
+	BENCHMARK_ADVANCED("void Board::detect_diagonal_angles(Plane plane)")(Catch::Benchmark::Chronometer meter) {
+		std::vector<std::unique_ptr<Board>> boards;
+		for(int i = 0; i < meter.runs(); ++i)
+			boards.push_back(std::make_unique<Board>(make_circles(8, t), Params(), t));
+		meter.measure([&](int i) { boards[i]->detect_diagonal_angles(XY); });
+	};
+
+	BENCHMARK_ADVANCED("void Board::detect_edges_in_polygons(Plane plane)")(Catch::Benchmark::Chronometer meter) {
+		std::vector<std::unique_ptr<Board>> boards;
+		for(int i = 0; i < meter.runs(); ++i)
+			boards.push_back(std::make_unique<Board>(make_circles(8, t), Params(), t));
+		meter.measure([&](int i) { boards[i]->detect_edges_in_polygons(XY); });
+	};
+}
+
+/// Same pairs of edges, through the virtual Segment accessors and through the
+/// final Edge ones.
+///*****************************************************************************
+TEST_CASE("Edge accessors", "[.][benchmark][edge]") {
+	Timepoint* t = Caretaker::singleton().get_history_root();
+	auto const polygons = make_circles(4, t);
+
+	std::vector<Edge const*> edges;
+	for(auto const& polygon : polygons[XY])
+		for(auto const& edge : polygon->edges)
+			edges.push_back(edge.get());
+
+	BENCHMARK("relation::SegmentSegment Segment::relation_to(Segment const& segment) const") {
+		std::size_t crossing = 0;
+		for(Segment const* a : edges)
+			for(Segment const* b : edges)
+				crossing += a->relation_to(*b) == relation::SegmentSegment::CROSSING;
+		return crossing;
+	};
+
+	BENCHMARK("relation::SegmentSegment Edge::relation_to(Edge const& edge) const noexcept") {
+		std::size_t crossing = 0;
+		for(Edge const* a : edges)
+			for(Edge const* b : edges)
+				crossing += a->relation_to(*b) == relation::SegmentSegment::CROSSING;
+		return crossing;
+	};
+
+	BENCHMARK("Bounding2D bounding(Segment const& a)") {
+		std::size_t overlapping = 0;
+		for(Segment const* a : edges)
+			for(Segment const* b : edges)
+				overlapping += does_overlap(bounding(*a), bounding(*b));
+		return overlapping;
+	};
+
+	BENCHMARK("Bounding2D const& bounding(Edge const& edge) noexcept") {
+		std::size_t overlapping = 0;
+		for(Edge const* a : edges)
+			for(Edge const* b : edges)
+				overlapping += does_overlap(bounding(*a), bounding(*b));
+		return overlapping;
+	};
+}
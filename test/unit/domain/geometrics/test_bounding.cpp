@@ -13,6 +13,7 @@
 /// @test bool does_overlap(Bounding2D const& a, Bounding2D const& b) noexcept
 /// @test bool does_overlap_strict(Bounding2D const& a, Bounding2D const& b) noexcept
 /// @test Bounding1D cast(ViewAxis axis, Bounding2D const& a) noexcept
+/// @test Bounding2D inflate(Bounding2D const& a, Coord const& margin) noexcept
 ///*****************************************************************************
 
 using namespace domain;
@@ -299,3 +300,23 @@ SCENARIO("Bounding1D cast(ViewAxis axis, Bounding2D const& a) noexcept", "[bound
 		}
 	}
 }
+
+//******************************************************************************
+SCENARIO("Bounding2D inflate(Bounding2D const& a, Coord const& margin) noexcept", "[bounding]") {
+	GIVEN("A bounding box") {
+		Bounding2D a({ 1, 4, 2, 3 });
+		WHEN("Inflating it") {
+			Bounding2D b = inflate(a, 0.5);
+			THEN("Should be grown by margin on each side") {
+				REQUIRE(b[XMIN] == 0.5);
+				REQUIRE(b[XMAX] == 4.5);
+				REQUIRE(b[YMIN] == 1.5);
+				REQUIRE(b[YMAX] == 3.5);
+			}
+			THEN("Should overlap boxes that were just apart") {
+				REQUIRE_FALSE(does_overlap(a, Bounding2D({ 4.2, 5, 2, 3 })));
+				REQUIRE(does_overlap(b, Bounding2D({ 4.2, 5, 2, 3 })));
+			}
+		}
+	}
+}
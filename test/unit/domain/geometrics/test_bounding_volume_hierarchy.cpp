@@ -0,0 +1,79 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+
+#include "domain/geometrics/bounding_volume_hierarchy.hpp"
+
+/// @test BoundingVolumeHierarchy::BoundingVolumeHierarchy(std::vector<Box> boxes)
+/// @test std::vector<std::size_t> BoundingVolumeHierarchy::find_overlapping(Bounding2D const& xy, std::optional<Bounding1D> const& z) const
+/// @test bool does_overlap(BoundingVolumeHierarchy::Box const& a, Bounding2D const& xy, std::optional<Bounding1D> const& z) noexcept
+///*****************************************************************************
+
+using namespace domain;
+
+//******************************************************************************
+SCENARIO("std::vector<std::size_t> BoundingVolumeHierarchy::find_overlapping(Bounding2D const& xy, std::optional<Bounding1D> const& z) const", "[bounding_volume_hierarchy]") {
+	GIVEN("An empty hierarchy") {
+		std::vector<BoundingVolumeHierarchy::Box> boxes;
+		BoundingVolumeHierarchy bvh(boxes);
+		THEN("Should not find anything") {
+			REQUIRE(bvh.size() == 0);
+			REQUIRE(bvh.find_overlapping({ 0, 1, 0, 1 }).empty());
+		}
+	}
+
+	GIVEN("A hierarchy over a grid of unit boxes, on two normal axis ranges") {
+		std::vector<BoundingVolumeHierarchy::Box> boxes;
+		for(int i = 0; i < 10; ++i)
+			for(int j = 0; j < 10; ++j)
+				boxes.push_back({{ 2 * i, 2 * i + 1, 2 * j, 2 * j + 1 }, { (i + j) % 2, (i + j) % 2 + 0.5 }});
+		BoundingVolumeHierarchy bvh(boxes);
+		REQUIRE(bvh.size() == 100);
+
+		WHEN("Looking for a box outside of all others") {
+			THEN("Should not find anything") {
+				REQUIRE(bvh.find_overlapping({ 50, 51, 50, 51 }).empty());
+				REQUIRE(bvh.find_overlapping({ 1.5, 1.8, 1.5, 1.8 }).empty());
+			}
+		}
+		WHEN("Looking for a box inside a single other") {
+			THEN("Should find it") {
+				REQUIRE(bvh.find_overlapping({ 4.2, 4.8, 6.2, 6.8 }) == std::vector<std::size_t>({ 23 }));
+			}
+		}
+		WHEN("Looking for a box touching some others") {
+			THEN("Should find all of them, sorted") {
+				REQUIRE(bvh.find_overlapping({ 1, 2, 1, 2 }) == std::vector<std::size_t>({ 0, 1, 10, 11 }));
+			}
+		}
+		WHEN("Looking for a box covering all others") {
+			THEN("Should find all of them") {
+				REQUIRE(bvh.find_overlapping({ -1, 20, -1, 20 }).size() == 100);
+			}
+		}
+		WHEN("Looking for a box with a normal axis range") {
+			THEN("Should only find boxes also overlapping on normal axis") {
+				REQUIRE(bvh.find_overlapping({ 1, 2, 1, 2 }, Bounding1D({ 0, 0.2 })) == std::vector<std::size_t>({ 0, 11 }));
+				REQUIRE(bvh.find_overlapping({ 1, 2, 1, 2 }, Bounding1D({ 0.8, 1 })) == std::vector<std::size_t>({ 1, 10 }));
+				REQUIRE(bvh.find_overlapping({ 1, 2, 1, 2 }, Bounding1D({ 0.6, 0.8 })).empty());
+			}
+		}
+		WHEN("Comparing to a brute force search") {
+			THEN("Should find the same boxes") {
+				for(Bounding2D const& xy : std::vector<Bounding2D>({{ 3, 7, 2, 9 }, { 0, 19, 5, 5 }, { 12.5, 12.5, 0, 19 }})) {
+					std::vector<std::size_t> expected;
+					for(std::size_t i = 0; i < boxes.size(); ++i)
+						if(does_overlap(boxes[i], xy, std::nullopt))
+							expected.push_back(i);
+					REQUIRE(bvh.find_overlapping(xy) == expected);
+				}
+			}
+		}
+	}
+}
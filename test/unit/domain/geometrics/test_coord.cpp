@@ -13,10 +13,19 @@
 /// @test Coord::operator double() const
 /// @test double Coord::value() const
 /// @test bool Coord::operator==(Coord const& a) const
+/// @test Coord snap(Coord const& a) noexcept
+/// @test std::int64_t to_database_units(Coord const& a) noexcept
 ///*****************************************************************************
 
 using namespace domain;
 
+/// Fixed-point mode for the scope of a test section.
+///*****************************************************************************
+struct FixedPointMode {
+	explicit FixedPointMode(double unit) { database_unit = unit; }
+	~FixedPointMode() { database_unit = 0; }
+};
+
 //******************************************************************************
 SCENARIO("Coord::operator double() const", "[coord]") {
 	GIVEN("A coord") {
@@ -86,3 +95,61 @@ SCENARIO("bool operator==(Coord const& a) const", "[coord]") {
 		}
 	}
 }
+
+//******************************************************************************
+SCENARIO("bool operator==(Coord const& a) const, in fixed-point mode", "[coord]") {
+	GIVEN("Fixed-point mode") {
+		FixedPointMode const mode(1e-3);
+		WHEN("We compare snapped coords") {
+			Coord a(snap(5.5 + 1e-4));
+			Coord b(snap(5.5 - 1e-4));
+			THEN("Should be exactly equal") {
+				REQUIRE(a.value() == b.value());
+				REQUIRE(to_database_units(a) == to_database_units(b));
+				REQUIRE(a == b);
+			}
+		}
+
+		WHEN("We compare derived coords just below the equality tolerance") {
+			Coord a(5.5);
+			Coord b(5.5 + equality_tolerance / 2);
+			THEN("Should still be equal, since they are not snapped") {
+				REQUIRE(a == b);
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("Coord snap(Coord const& a) noexcept", "[coord]") {
+	GIVEN("A coord off the database unit grid") {
+		Coord a(1.23456);
+		WHEN("Fixed-point mode is off") {
+			THEN("Should be left untouched") {
+				REQUIRE(snap(a).value() == a.value());
+			}
+		}
+
+		WHEN("Fixed-point mode is on") {
+			FixedPointMode const mode(1e-3);
+			THEN("Should be moved to the nearest multiple of the database unit") {
+				REQUIRE(to_database_units(snap(a)) == 1235);
+				REQUIRE(snap(a).value() == 1235 * 1e-3);
+				REQUIRE(snap(snap(a)).value() == snap(a).value());
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("std::int64_t to_database_units(Coord const& a) noexcept", "[coord]") {
+	GIVEN("Fixed-point mode") {
+		FixedPointMode const mode(1e-3);
+		THEN("Should count the database units") {
+			REQUIRE(to_database_units(Coord(0)) == 0);
+			REQUIRE(to_database_units(Coord(2.5)) == 2500);
+			REQUIRE(to_database_units(Coord(-2.5)) == -2500);
+			REQUIRE(to_database_units(Coord(2.5004)) == 2500);
+		}
+	}
+}
@@ -17,6 +17,7 @@
 /// @test std::optional<Range> overlap(Segment const* a, Segment const* b)
 /// @test bool operator==(Range const& a, Edge const& b)
 /// @test Edge::Edge(Plane plane, Point const* p0, Point const* p1)
+/// @test Bounding2D const& bounding(Edge const& edge) noexcept
 ///*****************************************************************************
 
 using namespace domain;
@@ -821,3 +822,17 @@ SCENARIO("Edge::Edge(Plane plane, Point const* p0, Point const* p1)", "[edge]")
 		}
 	}
 }
+
+//******************************************************************************
+SCENARIO("Bounding2D const& bounding(Edge const& edge) noexcept", "[edge]") {
+	Timepoint t;
+	GIVEN("A diagonal edge that grow down to the X and up to the Y") {
+		Point a0(3, 1), a1(1, 4);
+		Edge e(XY, &a0, &a1, &t);
+		THEN("Should be cached at construction and match the Segment one") {
+			REQUIRE(bounding(e) == Bounding2D({ 1, 3, 1, 4 }));
+			REQUIRE(&bounding(e) == &e.bounding);
+			REQUIRE(bounding(e) == bounding(static_cast<Segment const&>(e)));
+		}
+	}
+}
@@ -0,0 +1,66 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <catch2/catch_all.hpp>
+
+#include "domain/geometrics/expansion.hpp"
+
+/// @test void Expansion::add(double const a)
+/// @test void Expansion::add_product(double const a, double const b)
+/// @test int Expansion::sign() const noexcept
+///*****************************************************************************
+
+using namespace domain;
+
+//******************************************************************************
+SCENARIO("void Expansion::add(double const a)", "[expansion]") {
+	GIVEN("An empty expansion") {
+		Expansion e;
+		THEN("Its sign should be null") {
+			REQUIRE(e.sign() == 0);
+		}
+		WHEN("Adding numbers that cancel out exactly") {
+			e.add(0.1);
+			e.add(0.2);
+			e.add(-0.1);
+			e.add(-0.2);
+			THEN("Its sign should be null") {
+				REQUIRE(e.sign() == 0);
+			}
+		}
+		WHEN("Adding a number lost to rounding in floating-point") {
+			e.add(1e100);
+			e.add(1);
+			e.add(-1e100);
+			THEN("Its sign should still account for it") {
+				REQUIRE(1e100 + 1 - 1e100 == 0);
+				REQUIRE(e.sign() == 1);
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("void Expansion::add_product(double const a, double const b)", "[expansion]") {
+	GIVEN("An empty expansion") {
+		Expansion e;
+		WHEN("Adding products whose rounded values are equal") {
+			double const a = 1 + rounding_error * 2;
+			e.add_product(a, a);
+			e.add(-(a * a));
+			THEN("Its sign should be the one of the rounding error") {
+				REQUIRE(e.sign() == 1);
+			}
+		}
+		WHEN("Adding products that cancel out exactly") {
+			e.add_product(0.1, 0.3);
+			e.add_product(-0.3, 0.1);
+			THEN("Its sign should be null") {
+				REQUIRE(e.sign() == 0);
+			}
+		}
+	}
+}
@@ -0,0 +1,90 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "domain/geometrics/space.hpp"
+#include "utils/vector_utils.hpp"
+#include "domain/geometrics/edge.hpp"
+#include "domain/geometrics/point.hpp"
+#include "domain/geometrics/polygon.hpp"
+
+#include "domain/geometrics/geometry_store.hpp"
+
+/// @test GeometryStore::GeometryStore(std::vector<std::shared_ptr<Polygon>> const& polygons)
+/// @test Point GeometryStore::p0(std::size_t edge) const noexcept
+/// @test Point GeometryStore::p1(std::size_t edge) const noexcept
+/// @test Bounding2D const& GeometryStore::bounding(std::size_t edge) const noexcept
+/// @test Segment::Axis GeometryStore::axis(std::size_t edge) const noexcept
+/// @test std::size_t GeometryStore::polygon(std::size_t edge) const noexcept
+/// @test GeometryStore::EdgeRange GeometryStore::edges(std::size_t polygon) const noexcept
+/// @test BoundingVolumeHierarchy const& GeometryStore::edges_index() const noexcept
+///*****************************************************************************
+
+using namespace domain;
+
+//******************************************************************************
+SCENARIO("GeometryStore::GeometryStore(std::vector<std::shared_ptr<Polygon>> const& polygons)", "[geometry_store]") {
+	Timepoint t;
+	GIVEN("No polygon") {
+		std::vector<std::shared_ptr<Polygon>> polygons;
+		GeometryStore store(polygons);
+		THEN("Should not hold any edge") {
+			REQUIRE(store.size() == 0);
+			REQUIRE(store.edges_index().size() == 0);
+		}
+	}
+
+	GIVEN("A square and a triangle") {
+		std::vector<std::shared_ptr<Polygon>> polygons;
+		polygons.push_back(std::make_shared<Polygon>(XY, nullptr, "", 0, Polygon::RangeZ(0, 0), from_init_list<Point>({{ 1, 1 }, { 1, 3 }, { 3, 3 }, { 3, 1 }}), &t));
+		polygons.push_back(std::make_shared<Polygon>(XY, nullptr, "", 0, Polygon::RangeZ(0, 0), from_init_list<Point>({{ 4, 1 }, { 6, 3 }, { 6, 1 }}), &t));
+		GeometryStore store(polygons);
+
+		THEN("Should hold every edge, polygon by polygon") {
+			REQUIRE(store.size() == 7);
+			REQUIRE(store.edges_index().size() == 7);
+			REQUIRE(store.edges(0).first == 0);
+			REQUIRE(store.edges(0).last == 4);
+			REQUIRE(store.edges(1).first == 4);
+			REQUIRE(store.edges(1).last == 7);
+			for(std::size_t i = 0; i < 4; ++i)
+				REQUIRE(store.polygon(i) == 0);
+			for(std::size_t i = 4; i < 7; ++i)
+				REQUIRE(store.polygon(i) == 1);
+		}
+
+		THEN("Edges should match the polygon ones") {
+			for(std::size_t p = 0; p < polygons.size(); ++p) {
+				auto const [first, last] = store.edges(p);
+				for(std::size_t i = first; i < last; ++i) {
+					auto const& edge = polygons[p]->edges[i - first];
+					REQUIRE(store.p0(i) == edge->p0());
+					REQUIRE(store.p1(i) == edge->p1());
+					REQUIRE(store.axis(i) == edge->axis);
+					REQUIRE(store.bounding(i) == bounding(*edge));
+				}
+			}
+		}
+
+		THEN("Edge boundings should be cached") {
+			REQUIRE(store.bounding(0) == Bounding2D({ 1, 3, 1, 1 }));
+			REQUIRE(store.bounding(4) == Bounding2D({ 4, 6, 1, 1 }));
+			REQUIRE(store.bounding(5) == Bounding2D({ 4, 6, 1, 3 }));
+			REQUIRE(store.axis(0) == Segment::Axis::H);
+			REQUIRE(store.axis(1) == Segment::Axis::V);
+			REQUIRE(store.axis(5) == Segment::Axis::DIAGONAL);
+		}
+
+		THEN("Edges index should find edges around a given bounding") {
+			REQUIRE(store.edges_index().find_overlapping({ 6.5, 7, 0, 4 }).empty());
+			REQUIRE(store.edges_index().find_overlapping({ 4.9, 5.1, 1.9, 2.1 }) == std::vector<std::size_t>({ 5 }));
+		}
+	}
+}
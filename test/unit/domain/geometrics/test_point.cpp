@@ -15,6 +15,7 @@
 /// @test Point operator==(Point const& a, Point const& b) noexcept
 /// @test template<typename T> Point operator*(T const& n, Point const& p) noexcept
 /// @test template<typename T> Point operator*(Point const& p, T const& n) noexcept
+/// @test int orient2d(Point const& a, Point const& b, Point const& c) noexcept
 /// @test Point mid(Point const& a, Point const& b) noexcept
 /// @test Coord coord(Point const& point, ViewAxis const axis) noexcept
 ///*****************************************************************************
@@ -112,6 +113,38 @@ SCENARIO("template<typename T> Point operator*(T const& n, Point const& p)", "[p
 	}
 }
 
+//******************************************************************************
+SCENARIO("int orient2d(Point const& a, Point const& b, Point const& c) noexcept", "[point]") {
+	GIVEN("Two points") {
+		Point a(1, 1), b(3, 2);
+		THEN("A point on the left should be CCW") {
+			REQUIRE(orient2d(a, b, Point(0, 3)) == 1);
+		}
+		THEN("A point on the right should be CW") {
+			REQUIRE(orient2d(a, b, Point(3, 0)) == -1);
+		}
+		THEN("A point on the line should be colinear") {
+			REQUIRE(orient2d(a, b, Point(5, 3)) == 0);
+		}
+		THEN("A point close to the line should not be colinear") {
+			REQUIRE(orient2d(a, b, Point(5, 3 + equality_tolerance / 10)) == 1);
+			REQUIRE(orient2d(a, b, Point(5, 3 - equality_tolerance / 10)) == -1);
+		}
+	}
+
+	GIVEN("Nearly colinear points, where the floating-point filter is uncertain") {
+		Point a(0.1, 0.1), b(0.2, 0.2), c(0.3, 0.3);
+		THEN("Orientation should be consistent through permutations") {
+			int const r = orient2d(a, b, c);
+			REQUIRE(orient2d(b, c, a) == r);
+			REQUIRE(orient2d(c, a, b) == r);
+			REQUIRE(orient2d(b, a, c) == -r);
+			REQUIRE(orient2d(a, c, b) == -r);
+			REQUIRE(orient2d(c, b, a) == -r);
+		}
+	}
+}
+
 //******************************************************************************
 SCENARIO("Point mid(Point const& a, Point const& b)", "[point]") {
 	GIVEN("Two points") {
@@ -7,7 +7,10 @@
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
+
 #include "domain/geometrics/point.hpp"
+#include "domain/geometrics/range.hpp"
 
 #include "domain/geometrics/segment.hpp"
 
@@ -17,6 +20,8 @@
 /// @test std::optional<ViewAxis> cast(Segment::Axis const axis) noexcept
 /// @test Segment::Axis cast(ViewAxis const axis) noexcept
 /// @test std::optional<Coord> coord(Point const& point, Segment::Axis const axis) noexcept
+/// @test relation::SegmentSegment Segment::relation_to(Segment const& segment) const
+/// @test void relations_to(Segment const& a, std::span<Point const> b0s, std::span<Point const> b1s, std::span<relation::SegmentSegment> out) noexcept
 ///*****************************************************************************
 
 using namespace domain;
@@ -259,3 +264,47 @@ SCENARIO("std::optional<Coord> coord(Point const& point, Segment::Axis const axi
 		}
 	}
 }
+
+//******************************************************************************
+SCENARIO("relation::SegmentSegment Segment::relation_to(Segment const& segment) const", "[segment]") {
+	GIVEN("A diagonal segment") {
+		Range a(Point(0, 0), Point(2, 2));
+		THEN("Should detect crossing segments") {
+			REQUIRE(a.relation_to(Range(Point(0, 2), Point(2, 0))) == relation::SegmentSegment::CROSSING);
+			REQUIRE(a.relation_to(Range(Point(1, 0), Point(1, 3))) == relation::SegmentSegment::CROSSING);
+		}
+		THEN("Should detect apart segments") {
+			REQUIRE(a.relation_to(Range(Point(3, 0), Point(4, 1))) == relation::SegmentSegment::APART);
+			REQUIRE(a.relation_to(Range(Point(0, 1), Point(1, 2))) == relation::SegmentSegment::APART);
+		}
+		THEN("Should detect colinear segments") {
+			REQUIRE(a.relation_to(Range(Point(3, 3), Point(4, 4))) == relation::SegmentSegment::COLINEAR);
+		}
+		THEN("Should detect overlapping segments") {
+			REQUIRE(a.relation_to(Range(Point(1, 1), Point(4, 4))) == relation::SegmentSegment::OVERLAPPING);
+			REQUIRE(a.relation_to(Range(Point(2, 2), Point(3, 3))) == relation::SegmentSegment::OVERLAPPING);
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("void relations_to(Segment const& a, std::span<Point const> b0s, std::span<Point const> b1s, std::span<relation::SegmentSegment> out) noexcept", "[segment]") {
+	GIVEN("A segment and a contiguous span of segments") {
+		Range a(Point(0, 0), Point(2, 2));
+		std::array<Point const, 5> b0s({ Point(0, 2), Point(3, 0), Point(3, 3), Point(1, 1), Point(1, 0) });
+		std::array<Point const, 5> b1s({ Point(2, 0), Point(4, 1), Point(4, 4), Point(4, 4), Point(1, 3) });
+		std::array<relation::SegmentSegment, 5> out;
+		WHEN("Relating the segment to the whole span") {
+			relations_to(a, b0s, b1s, out);
+			THEN("Should match Segment::relation_to for each segment") {
+				for(std::size_t i = 0; i < out.size(); ++i)
+					REQUIRE(out[i] == a.relation_to(Range(b0s[i], b1s[i])));
+				REQUIRE(out[0] == relation::SegmentSegment::CROSSING);
+				REQUIRE(out[1] == relation::SegmentSegment::APART);
+				REQUIRE(out[2] == relation::SegmentSegment::COLINEAR);
+				REQUIRE(out[3] == relation::SegmentSegment::OVERLAPPING);
+				REQUIRE(out[4] == relation::SegmentSegment::CROSSING);
+			}
+		}
+	}
+}
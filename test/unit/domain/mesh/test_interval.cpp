@@ -6,6 +6,9 @@
 
 #include <catch2/catch_all.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <vector>
 
 #include "domain/mesh/meshline.hpp"
@@ -13,7 +16,7 @@
 
 #include "domain/mesh/interval.hpp"
 
-/// @test Interval::Side::Side(MeshlinePolicy* meshline_policy, size_t lmin, double smoothness, Coord h, function<double (double)> d_init)
+/// @test Interval::Side::Side(MeshlinePolicy* meshline_policy, size_t lmin, double smoothness, Coord h, function<double (double)> d_init, bool limit_d)
 /// @test double Interval::Side::d_init_(double d)
 /// @test Coord Interval::s(Interval::Side const& side) const @todo
 /// @test Coord Interval::s(Interval::Side const& side, double d) const @todo
@@ -24,7 +27,7 @@
 /// @test double find_dmax(Interval::Side const& side, double dmax)
 /// @test double find_dmax(Interval::Side const& side, Interval::Side const& b, double dmax)
 /// @test std::tuple<double, bool> Interval::adjust_d_for_dmax_lmin(Interval::Side const& side, size_t iter_limit) const
-/// @test std::tuple<double, bool> Interval::adjust_smoothness_for_s(Interval::Side const& side, size_t iter_limit) const
+/// @test std::tuple<double, bool, std::size_t> Interval::adjust_smoothness_for_s(Interval::Side const& side, size_t iter_limit, size_t step) const
 /// @test void Interval::auto_solve_d() @todo
 /// @test void Interval::auto_solve_smoothness() @todo
 /// @test std::vector<std::unique_ptr<Meshline>> Interval::mesh() const
@@ -33,7 +36,7 @@
 using namespace domain;
 
 //******************************************************************************
-SCENARIO("Interval::Side::Side(MeshlinePolicy* meshline_policy, size_t lmin, double smoothness, Coord h, function<double (double)> d_init)", "[interval]") {
+SCENARIO("Interval::Side::Side(MeshlinePolicy* meshline_policy, size_t lmin, double smoothness, Coord h, function<double (double)> d_init, bool limit_d)", "[interval]") {
 	Timepoint* t = Caretaker::singleton().get_history_root();
 	GIVEN("Two meshline policies") {
 		GlobalParams p(t);
@@ -64,6 +67,16 @@ SCENARIO("Interval::Side::Side(MeshlinePolicy* meshline_policy, size_t lmin, dou
 				REQUIRE(b.get_current_state().d == 5);
 			}
 		}
+
+		WHEN("Creating an Interval's sides without limiting d") {
+			Timepoint* before = b.get_current_timepoint();
+			Interval i(&a, &b, Y, &p, t, false);
+			THEN("Meshline policies should be left untouched") {
+				REQUIRE(a.get_current_state().d == 2);
+				REQUIRE(b.get_current_state().d == 15);
+				REQUIRE(b.get_current_timepoint() == before);
+			}
+		}
 	}
 }
 
@@ -674,12 +687,27 @@ SCENARIO("std::tuple<double, bool> Interval::adjust_d_for_dmax_lmin(Interval::Si
 					}
 				}
 			}
+
+			AND_WHEN("Compared to a linear search decreasing d by d/1000 at each iteration") {
+				auto const& side = i.get_current_state().before;
+				double const dmax = p.get_current_state().dmax;
+				double d = std::min(a.get_current_state().d, dmax);
+				std::size_t k = 0;
+				while(!is_ls_valid_for_dmax_lmin_smoothness(find_ls(d, side.smoothness, dmax, i.s(side, d)), d, side.smoothness, dmax, side.lmin)) {
+					d -= d / 1000;
+					++k;
+				}
+				THEN("Side's d should be the same") {
+					REQUIRE(k > 20);
+					REQUIRE(std::get<0>(i.adjust_d_for_dmax_lmin(side)) == d);
+				}
+			}
 		}
 	}
 }
 
 //******************************************************************************
-SCENARIO("std::tuple<double, bool> Interval::adjust_smoothness_for_s(Interval::Side const& side, size_t iter_limit) const", "[interval]") {
+SCENARIO("std::tuple<double, bool, std::size_t> Interval::adjust_smoothness_for_s(Interval::Side const& side, size_t iter_limit, size_t step) const", "[interval]") {
 	Timepoint* t = Caretaker::singleton().get_history_root();
 	GIVEN("A Side of an Interval with previously computed valid ls with smoothness superior to 2") {
 		GlobalParams p(t);
@@ -729,7 +757,7 @@ SCENARIO("std::tuple<double, bool> Interval::adjust_smoothness_for_s(Interval::S
 		WHEN("Process iterations are unlimited") {
 			THEN("Side's smoothness should be reduced") {
 				{
-					auto [new_smoothness, is_limit_reached] = i.adjust_smoothness_for_s(i.get_current_state().before);
+					auto [new_smoothness, is_limit_reached, iterations] = i.adjust_smoothness_for_s(i.get_current_state().before);
 					auto state_i = i.get_current_state();
 					state_i.before.smoothness = new_smoothness;
 					i.update_ls(state_i);
@@ -745,7 +773,7 @@ SCENARIO("std::tuple<double, bool> Interval::adjust_smoothness_for_s(Interval::S
 					AND_WHEN("Process iterations are limited") {
 						THEN("Side's smoothness should be reduced") {
 							{
-								auto [new_smoothness, is_limit_reached] = j.adjust_smoothness_for_s(j.get_current_state().before, 20);
+								auto [new_smoothness, is_limit_reached, iterations] = j.adjust_smoothness_for_s(j.get_current_state().before, 20);
 								auto state_j = j.get_current_state();
 								state_j.before.smoothness = new_smoothness;
 								j.update_ls(state_j);
@@ -764,6 +792,35 @@ SCENARIO("std::tuple<double, bool> Interval::adjust_smoothness_for_s(Interval::S
 				}
 			}
 		}
+
+		WHEN("Compared to a linear search decreasing smoothness by smoothness/10000 at each iteration") {
+			auto const& side = i.get_current_state().before;
+			double smoothness = side.smoothness;
+			std::size_t k = 0;
+			for(;;) {
+				double const next_smoothness = std::max(1.0, smoothness - smoothness / 10000);
+				if(find_ls(a.get_current_state().d, next_smoothness, p.get_current_state().dmax, i.s(side)).size() > side.ls.size())
+					break;
+				smoothness = next_smoothness;
+				++k;
+				if(smoothness == 1)
+					break;
+			}
+			THEN("Side's smoothness should be the same, with much fewer iterations") {
+				auto [new_smoothness, is_limit_reached, iterations] = i.adjust_smoothness_for_s(side);
+				REQUIRE(new_smoothness == smoothness);
+				REQUIRE_FALSE(is_limit_reached);
+				REQUIRE(k > 100);
+				REQUIRE(iterations < k / 10);
+			}
+			AND_WHEN("Precision is coarser") {
+				THEN("Side's smoothness should be reduced, but not below the precise one") {
+					auto [new_smoothness, is_limit_reached, iterations] = i.adjust_smoothness_for_s(side, std::numeric_limits<std::size_t>::max(), 100);
+					REQUIRE(new_smoothness < side.smoothness);
+					REQUIRE(new_smoothness >= smoothness);
+				}
+			}
+		}
 	}
 
 	GIVEN("A Side of an Interval with previously computed valid ls with smoothness being 1") {
@@ -802,7 +859,7 @@ SCENARIO("std::tuple<double, bool> Interval::adjust_smoothness_for_s(Interval::S
 			p.get_current_state().dmax,
 			p.get_current_state().lmin));
 		THEN("Side's smoothness should not be reduced") {
-			auto [new_smoothness, is_limit_reached] = i.adjust_smoothness_for_s(i.get_current_state().before);
+			auto [new_smoothness, is_limit_reached, iterations] = i.adjust_smoothness_for_s(i.get_current_state().before);
 			auto state_i = i.get_current_state();
 			state_i.before.smoothness = new_smoothness;
 			i.update_ls(state_i);
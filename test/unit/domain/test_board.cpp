@@ -1551,6 +1551,51 @@ SCENARIO("void Board::detect_colinear_edges()", "[board]") {
 			}
 		}
 
+		WHEN("Three vertical edges form a non transitive chain within equality tolerance") {
+			// First ≈ third, third ≈ second, but first ≠ second.
+			std::unique_ptr<Board> b;
+			{
+				PlaneSpace<std::vector<std::shared_ptr<Polygon>>> tmp;
+				tmp[XY].push_back(std::make_shared<Polygon>(XY, material, "", 0, Polygon::RangeZ { 0, 0 }, from_init_list<Point>({{ 1, 1 }, { 2, 1 }, { 2, 2 }, { 1, 2 }}), t));
+				tmp[XY].push_back(std::make_shared<Polygon>(XY, material, "", 0, Polygon::RangeZ { 0, 0 }, from_init_list<Point>({{ 0.5, 3 }, { 2 + 1.6e-8, 3 }, { 2 + 1.6e-8, 4 }, { 0.5, 4 }}), t));
+				tmp[XY].push_back(std::make_shared<Polygon>(XY, material, "", 0, Polygon::RangeZ { 0, 0 }, from_init_list<Point>({{ 3, 5 }, { 2 + 0.8e-8, 5 }, { 2 + 0.8e-8, 6 }, { 3, 6 }}), t));
+				b = std::make_unique<Board>(std::move(tmp), Params(), t);
+			}
+			Edge* first = b->get_current_state().polygons[XY][0]->edges[2].get();
+			Edge* second = b->get_current_state().polygons[XY][1]->edges[2].get();
+			Edge* third = b->get_current_state().polygons[XY][2]->edges[2].get();
+			REQUIRE(first->p0().x == third->p0().x);
+			REQUIRE(third->p0().x == second->p0().x);
+			REQUIRE_FALSE(first->p0().x == second->p0().x);
+			b->detect_colinear_edges();
+			THEN("A single COLINEAR_EDGES conflict should be registered, as by an all pairs search") {
+				REQUIRE(b->conflict_manager->get_current_state().all_colinear_edges[X].size() == 1);
+				AND_THEN("Its edges should be in the all pairs search order") {
+					ConflictColinearEdges* c = b->conflict_manager->get_current_state().all_colinear_edges[X].back().get();
+					REQUIRE(c->get_current_state().edges == std::vector<Edge*>({ first, third, second }));
+				}
+			}
+		}
+
+		WHEN("In fixed-point mode, three polygons share a vertical edge up to rounding") {
+			database_unit = 1e-6;
+			Board::Builder builder;
+			builder.add_polygon(XY, material, "", 0, { 0, 0 }, {{ 1, 1 }, { 2, 1 }, { 2, 2 }, { 1, 2 }});
+			builder.add_polygon(XY, material, "", 0, { 0, 0 }, {{ 0.5, 3 }, { 2 + 1e-7, 3 }, { 2 + 1e-7, 4 }, { 0.5, 4 }});
+			builder.add_polygon(XY, material, "", 0, { 0, 0 }, {{ 3, 5 }, { 2 - 1e-7, 5 }, { 2 - 1e-7, 6 }, { 3, 6 }});
+			std::shared_ptr<Board> b = builder.build();
+			b->detect_colinear_edges();
+			database_unit = 0;
+			THEN("Edges should have been snapped") {
+				REQUIRE(b->get_current_state().polygons[XY][1]->edges[2]->p0().x.value() == 2);
+				REQUIRE(b->get_current_state().polygons[XY][2]->edges[2]->p0().x.value() == 2);
+			}
+			THEN("A single COLINEAR_EDGES conflict between the three edges should be registered") {
+				REQUIRE(b->conflict_manager->get_current_state().all_colinear_edges[X].size() == 1);
+				REQUIRE(b->conflict_manager->get_current_state().all_colinear_edges[X].back()->get_current_state().edges.size() == 3);
+			}
+		}
+
 		WHEN("Three polygons share a colinear diagonal edge") {
 			std::unique_ptr<Board> b;
 			{
@@ -19,6 +19,7 @@
 #include "domain/conflict_manager.hpp"
 
 /// @test void ConflictManager::add_colinear_edges(Edge* a, Edge* b)
+/// @test void ConflictManager::add_colinear_edges(std::vector<Edge*> const& edges)
 /// @test void ConflictManager::add_edge_in_polygon(
 ///       	Edge* a,
 ///       	Polygon* polygon,
@@ -27,6 +28,7 @@
 /// @test ConflictTooCloseMeshlinePolicies& ConflictManager::add_too_close_meshline_policies(
 ///       	MeshlinePolicy* a,
 ///       	MeshlinePolicy* b)
+/// @test ConflictManager::Transaction::Transaction(ConflictManager& manager, Timepoint* t)
 ///*****************************************************************************
 
 using namespace domain;
@@ -252,6 +254,47 @@ SCENARIO("void ConflictManager::add_colinear_edges(Edge* a, Edge* b)", "[conflic
 	}
 }
 
+//******************************************************************************
+SCENARIO("void ConflictManager::add_colinear_edges(std::vector<Edge*> const& edges)", "[conflict_manager]") {
+	Timepoint* t = Caretaker::singleton().get_history_root();
+	GIVEN("A conflict manager and some edges") {
+		ConflictManager cm(t);
+		Point a0(1, 1), a1(1, 2);
+		Point b0(1, 3), b1(1, 4);
+		Point c0(1, 5), c1(1, 6);
+		Edge a(XY, &a0, &a1, t);
+		Edge b(XY, &b0, &b1, t);
+		Edge c(XY, &c0, &c1, t);
+		WHEN("Three vertical edges that are colinear are reported at once") {
+			cm.add_colinear_edges({ &a, &b, &c });
+			THEN("A single COLINEAR_EDGES conflict holding all of them should be registered") {
+				REQUIRE(cm.get_current_state().all_colinear_edges[X].size() == 1);
+				ConflictColinearEdges* conflict = cm.get_current_state().all_colinear_edges[X][0].get();
+				REQUIRE(conflict->get_current_state().edges == std::vector<Edge*>({ &a, &b, &c }));
+				REQUIRE(a.get_current_state().conflicts == std::vector<Conflict*>({ conflict }));
+				REQUIRE(b.get_current_state().conflicts == std::vector<Conflict*>({ conflict }));
+				REQUIRE(c.get_current_state().conflicts == std::vector<Conflict*>({ conflict }));
+			}
+		}
+		WHEN("Some of the edges are already in a COLINEAR_EDGES conflict") {
+			cm.add_colinear_edges(&b, &c);
+			cm.add_colinear_edges({ &a, &b, &c });
+			THEN("The missing edges should be appended to the existing conflict") {
+				REQUIRE(cm.get_current_state().all_colinear_edges[X].size() == 1);
+				ConflictColinearEdges* conflict = cm.get_current_state().all_colinear_edges[X][0].get();
+				REQUIRE(conflict->get_current_state().edges == std::vector<Edge*>({ &b, &c, &a }));
+				REQUIRE(a.get_current_state().conflicts == std::vector<Conflict*>({ conflict }));
+			}
+		}
+		WHEN("A single edge is reported") {
+			cm.add_colinear_edges({ &a });
+			THEN("No conflict should be registered") {
+				REQUIRE_FALSE(cm.get_current_state().all_colinear_edges[X].size());
+			}
+		}
+	}
+}
+
 //******************************************************************************
 SCENARIO("void ConflictManager::add_edge_in_polygon(Edge* a, Polygon* polygon, Range const range, std::optional<Edge const*> b)", "[conflict_manager]") {
 	Timepoint* t = Caretaker::singleton().get_history_root();
@@ -739,3 +782,56 @@ MeshlinePolicy* b)", "[conflict_manager]") {
 		}
 	}
 }
+
+//******************************************************************************
+SCENARIO("ConflictManager::Transaction::Transaction(ConflictManager& manager, Timepoint* t)", "[conflict_manager]") {
+	Timepoint* t = Caretaker::singleton().get_history_root();
+	GIVEN("A conflict manager and some vertical colinear edges") {
+		ConflictManager cm(t);
+		Point a0(1, 1), a1(1, 2);
+		Point b0(1, 3), b1(1, 4);
+		Point c0(1, 5), c1(1, 6);
+		Point d0(2, 5), d1(2, 6);
+		Point e0(2, 7), e1(2, 8);
+		Edge a(XY, &a0, &a1, t);
+		Edge b(XY, &b0, &b1, t);
+		Edge c(XY, &c0, &c1, t);
+		Edge d(XY, &d0, &d1, t);
+		Edge e(XY, &e0, &e1, t);
+		std::size_t const states = cm.get_available_states().size();
+
+		WHEN("They are reported as colinear during a transaction") {
+			{
+				ConflictManager::Transaction const transaction(cm);
+				cm.add_colinear_edges(&a, &b);
+				cm.add_colinear_edges(&d, &e);
+				cm.add_colinear_edges(&c, &a);
+				cm.add_colinear_edges(&b, &c);
+				THEN("Conflicts should not be visible before the transaction ends") {
+					REQUIRE(cm.get_current_state().all_colinear_edges[X].empty());
+				}
+			}
+
+			THEN("All conflicts should be registered as a single new state") {
+				REQUIRE(cm.get_available_states().size() == states + 1);
+				REQUIRE(cm.get_current_state().all_colinear_edges[X].size() == 2);
+				ConflictColinearEdges* conflict_abc = cm.get_current_state().all_colinear_edges[X][0].get();
+				ConflictColinearEdges* conflict_de = cm.get_current_state().all_colinear_edges[X][1].get();
+				REQUIRE(conflict_abc->get_current_state().edges == std::vector<Edge*>({ &a, &b, &c }));
+				REQUIRE(conflict_de->get_current_state().edges == std::vector<Edge*>({ &d, &e }));
+				REQUIRE(c.get_current_state().conflicts == std::vector<Conflict*>({ conflict_abc }));
+				REQUIRE(e.get_current_state().conflicts == std::vector<Conflict*>({ conflict_de }));
+			}
+		}
+
+		WHEN("Nothing is reported during a transaction") {
+			{
+				ConflictManager::Transaction const transaction(cm);
+			}
+
+			THEN("No state should be added") {
+				REQUIRE(cm.get_available_states().size() == states);
+			}
+		}
+	}
+}
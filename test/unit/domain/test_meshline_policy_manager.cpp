@@ -6,11 +6,14 @@
 
 #include <catch2/catch_all.hpp>
 
+#include <cstddef>
 #include <vector>
 
+#include "domain/geometrics/angle.hpp"
 #include "domain/geometrics/edge.hpp"
 #include "domain/geometrics/point.hpp"
 #include "domain/conflict_manager.hpp"
+#include "utils/vector_utils.hpp"
 
 #include "domain/meshline_policy_manager.hpp"
 
@@ -21,12 +24,15 @@
 ///       	Normal const normal,
 ///       	Coord const coord,
 ///       	bool const is_enabled)
+/// @test MeshlinePolicyManager::Transaction::Transaction(MeshlinePolicyManager& manager, Timepoint* t)
 /// @test optional<array<MeshlinePolicy*, 2>> detect_closest_meshline_policies(
 ///       	vector<MeshlinePolicy*> dimension,
 ///       	Coord proximity_limit)
 /// @test void MeshlinePolicyManager::detect_and_solve_too_close_meshline_policies()
 /// @test void MeshlinePolicyManager::detect_intervals()
+/// @test void MeshlinePolicyManager::detect_intervals_per_diagonal_zones(Axis const axis)
 /// @test void MeshlinePolicyManager::mesh()
+/// @test void MeshlinePolicyManager::mesh_in_parallel(std::size_t nthreads)
 ///*****************************************************************************
 
 using namespace domain;
@@ -102,6 +108,64 @@ bool const is_enabled)", "[meshline_policy_manager]") {
 	}
 }
 
+//******************************************************************************
+SCENARIO("MeshlinePolicyManager::Transaction::Transaction(MeshlinePolicyManager& manager, Timepoint* t)", "[meshline_policy_manager]") {
+	Timepoint* t = Caretaker::singleton().get_history_root();
+	GIVEN("A meshline policy manager") {
+		GlobalParams params(t);
+		MeshlinePolicyManager mpm(&params, t);
+		Point e0(1, 1), e1(1, 3);
+		Edge e(XY, &e0, &e1, t);
+		std::size_t const states = mpm.get_available_states().size();
+
+		WHEN("Adding some meshline policies during a transaction") {
+			{
+				MeshlinePolicyManager::Transaction const transaction(mpm);
+				for(double coord : { 10.0, 20.0, 30.0 })
+					mpm.add_meshline_policy(
+						{ &e },
+						Y,
+						MeshlinePolicy::Policy::HALFS,
+						MeshlinePolicy::Normal::NONE,
+						coord);
+				mpm.add_meshline_policy(
+					{ &e },
+					X,
+					MeshlinePolicy::Policy::ONELINE,
+					MeshlinePolicy::Normal::NONE,
+					5);
+
+				THEN("They should only be pending until the transaction ends") {
+					REQUIRE(mpm.get_meshline_policies(Y).empty());
+					REQUIRE(mpm.get_pending_meshline_policies(Y).size() == 3);
+					REQUIRE(mpm.get_pending_meshline_policies(X).size() == 1);
+					REQUIRE(mpm.get_available_states().size() == states);
+				}
+			}
+
+			THEN("They should all be added, in order, as a single new state") {
+				REQUIRE(mpm.get_pending_meshline_policies(Y).empty());
+				REQUIRE(mpm.get_available_states().size() == states + 1);
+				REQUIRE(mpm.get_meshline_policies(X).size() == 1);
+				REQUIRE(mpm.get_meshline_policies(Y).size() == 3);
+				REQUIRE(mpm.get_meshline_policies(Y)[0]->coord == 10);
+				REQUIRE(mpm.get_meshline_policies(Y)[1]->coord == 20);
+				REQUIRE(mpm.get_meshline_policies(Y)[2]->coord == 30);
+			}
+		}
+
+		WHEN("No meshline policy is added during a transaction") {
+			{
+				MeshlinePolicyManager::Transaction const transaction(mpm);
+			}
+
+			THEN("No state should be added") {
+				REQUIRE(mpm.get_available_states().size() == states);
+			}
+		}
+	}
+}
+
 //******************************************************************************
 SCENARIO("optional<array<MeshlinePolicy*, 2>> detect_closest_meshline_policies( \
 vector<MeshlinePolicy*> dimension, \
@@ -387,6 +451,34 @@ SCENARIO("void MeshlinePolicyManager::detect_and_solve_too_close_meshline_polici
 			REQUIRE(w.mpm.get_current_state().line_policies[Y][7]->get_current_state().is_enabled);
 		}
 	}
+
+	GIVEN("A meshline policy manager and a dense regular grid of ONELINE meshline policies") {
+		Wrapper w(t);
+		auto params_state = w.params.get_current_state();
+		params_state.proximity_limit = 1;
+		w.params.set_next_state(params_state);
+		Point e0(1, 1), e1(1, 3);
+		Edge e(XY, &e0, &e1, t);
+
+		for(int j = 0; j < 200; ++j)
+			w.mpm.add_meshline_policy(
+				{ &e },
+				Y,
+				MeshlinePolicy::Policy::ONELINE,
+				MeshlinePolicy::Normal::NONE,
+				0.3 * j);
+
+		THEN("No enabled meshline policies should remain closer than the proximity limit") {
+			w.mpm.detect_and_solve_too_close_meshline_policies();
+			REQUIRE_FALSE(detect_closest_meshline_policies(create_view(w.mpm.get_current_state().line_policies[Y]), 1));
+			std::size_t enabled = 0;
+			for(auto const& policy : w.mpm.get_current_state().line_policies[Y])
+				if(policy->get_current_state().is_enabled)
+					++enabled;
+			REQUIRE(enabled > 0);
+			REQUIRE(enabled < 200);
+		}
+	}
 }
 
 //******************************************************************************
@@ -485,6 +577,82 @@ SCENARIO("void MeshlinePolicyManager::detect_intervals()", "[meshline_policy_man
 	}
 }
 
+//******************************************************************************
+SCENARIO("void MeshlinePolicyManager::detect_intervals_per_diagonal_zones(Axis const axis)", "[meshline_policy_manager]") {
+	Timepoint* t = Caretaker::singleton().get_history_root();
+
+	class Wrapper {
+	public:
+		GlobalParams params;
+		ConflictManager cm;
+		MeshlinePolicyManager mpm;
+
+		Wrapper(Timepoint* t)
+		: params(t)
+		, cm(t)
+		, mpm(&params, t)
+		{
+			cm.init(&mpm);
+			mpm.init(&cm);
+		}
+	};
+
+	GIVEN("Intervals and two overlapping diagonal zones") {
+		Wrapper w(t);
+		Point e0(0, 0), e1(1, 1), e2(2, 0);
+		Edge e(XY, &e0, &e1, t);
+		Edge f(XY, &e1, &e2, t);
+		Angle a0(Point(0, 10), &e, &f, t);
+		Angle a1(Point(0, 20), &e, &f, t);
+		Angle b0(Point(0, 15), &e, &f, t);
+		Angle b1(Point(0, 25), &e, &f, t);
+		w.cm.add_diagonal_or_circular_zone(Y, { &a0, &a1 }, &w.params);
+		w.cm.add_diagonal_or_circular_zone(Y, { &b0, &b1 }, &w.params);
+
+		// Interval middles : 6  13  16  20  26
+		for(double coord : { 30.0, 0.0, 18.0, 12.0, 22.0, 14.0 })
+			w.mpm.add_meshline_policy(
+				{ &e },
+				Y,
+				MeshlinePolicy::Policy::ONELINE,
+				MeshlinePolicy::Normal::NONE,
+				coord);
+		w.mpm.detect_intervals(Y);
+		REQUIRE(w.mpm.get_intervals(Y).size() == 5);
+
+		WHEN("Detecting Intervals per diagonal zones") {
+			w.mpm.detect_intervals_per_diagonal_zones(Y);
+			auto const& zones = w.cm.get_diagonal_or_circular_zones(Y);
+			REQUIRE(zones.size() == 2);
+
+			auto const middles = [](std::vector<Interval*> const& intervals) {
+				std::vector<double> m;
+				for(auto const* interval : intervals)
+					m.push_back(interval->m.value());
+				return m;
+			};
+
+			THEN("Each zone should hold the Intervals whose middle lies inside, sorted") {
+				REQUIRE(middles(zones[0]->get_current_state().intervals) == std::vector<double>({ 13, 16, 20 }));
+				REQUIRE(middles(zones[1]->get_current_state().intervals) == std::vector<double>({ 16, 20 }));
+			}
+
+			THEN("Each Interval should hold all the zones it lies in") {
+				for(auto const& interval : w.mpm.get_intervals(Y)) {
+					auto const& conflicts = interval->get_current_state().conflicts;
+					if(interval->m == 6 || interval->m == 26) {
+						REQUIRE(conflicts.empty());
+					} else if(interval->m == 13) {
+						REQUIRE(conflicts == std::vector<Conflict*>({ zones[0].get() }));
+					} else {
+						REQUIRE(conflicts == std::vector<Conflict*>({ zones[0].get(), zones[1].get() }));
+					}
+				}
+			}
+		}
+	}
+}
+
 //******************************************************************************
 SCENARIO("void MeshlinePolicyManager::mesh()", "[meshline_policy_manager]") {
 	Timepoint* t = Caretaker::singleton().get_history_root();
@@ -551,8 +719,8 @@ SCENARIO("void MeshlinePolicyManager::mesh()", "[meshline_policy_manager]") {
 
 		THEN("Meshlines should be sorted") {
 			REQUIRE(w.mpm.get_current_state().meshlines[Y].size() > 2);
-			for(auto it = next(begin(w.mpm.get_current_state().meshlines[Y])); it != end(w.mpm.get_current_state().meshlines[Y]); ++it)
-				REQUIRE((*prev(it))->coord < (*it)->coord);
+			for(auto it = std::next(begin(w.mpm.get_current_state().meshlines[Y])); it != end(w.mpm.get_current_state().meshlines[Y]); ++it)
+				REQUIRE((*std::prev(it))->coord < (*it)->coord);
 		}
 
 		THEN("ONELINE meshlines should be placed precisely") {
@@ -569,15 +737,15 @@ SCENARIO("void MeshlinePolicyManager::mesh()", "[meshline_policy_manager]") {
 
 		THEN("Every space should be thiner than dmax") {
 			REQUIRE(w.mpm.get_current_state().meshlines[Y].size() > 2);
-			for(auto it = next(begin(w.mpm.get_current_state().meshlines[Y])); it != end(w.mpm.get_current_state().meshlines[Y]); ++it)
-				REQUIRE(distance((*prev(it))->coord, (*it)->coord) <= 4.0);
+			for(auto it = std::next(begin(w.mpm.get_current_state().meshlines[Y])); it != end(w.mpm.get_current_state().meshlines[Y]); ++it)
+				REQUIRE(distance((*std::prev(it))->coord, (*it)->coord) <= 4.0);
 		}
 
 		THEN("Every space should be [0.5; 2] times its adjacent spaces") {
 			REQUIRE(w.mpm.get_current_state().meshlines[Y].size() > 2);
-			for(auto it = next(begin(w.mpm.get_current_state().meshlines[Y]), 2); it != end(w.mpm.get_current_state().meshlines[Y]); ++it) {
-				Coord a(distance((*prev(it, 2))->coord, (*prev(it))->coord));
-				Coord b(distance((*prev(it))->coord, (*it)->coord));
+			for(auto it = std::next(begin(w.mpm.get_current_state().meshlines[Y]), 2); it != end(w.mpm.get_current_state().meshlines[Y]); ++it) {
+				Coord a(distance((*std::prev(it, 2))->coord, (*std::prev(it))->coord));
+				Coord b(distance((*std::prev(it))->coord, (*it)->coord));
 				REQUIRE(a <= b * 2);
 				REQUIRE(a >= b / 2);
 			}
@@ -601,3 +769,70 @@ SCENARIO("void MeshlinePolicyManager::mesh()", "[meshline_policy_manager]") {
 		}
 	}
 }
+
+//******************************************************************************
+SCENARIO("void MeshlinePolicyManager::mesh_in_parallel(std::size_t nthreads)", "[meshline_policy_manager]") {
+	Timepoint* t = Caretaker::singleton().get_history_root();
+
+	class Wrapper {
+	public:
+		GlobalParams params;
+		ConflictManager cm;
+		MeshlinePolicyManager mpm;
+
+		Wrapper(Timepoint* t)
+		: params(t)
+		, cm(t)
+		, mpm(&params, t)
+		{
+			cm.init(&mpm);
+			mpm.init(&cm);
+		}
+	};
+
+	GIVEN("Two meshline policy managers with the same meshline policies on all axes") {
+		Wrapper serial(t);
+		Wrapper parallel(t);
+		Point e0(1, 1), e1(1, 3);
+		Edge e(XY, &e0, &e1, t);
+
+		for(Wrapper* w : { &serial, &parallel }) {
+			auto params_state = w->params.get_current_state();
+			params_state.proximity_limit = 0.1;
+			params_state.lmin = 2;
+			params_state.dmax = 1.5;
+			w->params.set_next_state(params_state);
+
+			for(auto const& axis : AllAxis) {
+				double coord = 0;
+				for(std::size_t i = 0; i < 40; ++i) {
+					coord += 0.5 + (double) ((i * 7 + axis * 3) % 11);
+					switch(i % 4) {
+					case 0: w->mpm.add_meshline_policy({ &e }, axis, MeshlinePolicy::Policy::ONELINE, MeshlinePolicy::Normal::NONE, coord); break;
+					case 1: w->mpm.add_meshline_policy({ &e }, axis, MeshlinePolicy::Policy::HALFS, MeshlinePolicy::Normal::NONE, coord); break;
+					case 2: w->mpm.add_meshline_policy({ &e }, axis, MeshlinePolicy::Policy::THIRDS, MeshlinePolicy::Normal::MIN, coord); break;
+					case 3: w->mpm.add_meshline_policy({ &e }, axis, MeshlinePolicy::Policy::THIRDS, MeshlinePolicy::Normal::MAX, coord); break;
+					}
+				}
+			}
+
+			w->mpm.detect_intervals();
+		}
+
+		WHEN("Meshing one axis after another, and all axes on four threads") {
+			serial.mpm.mesh();
+			parallel.mpm.mesh_in_parallel(4);
+
+			THEN("Meshlines should be exactly the same") {
+				for(auto const& axis : AllAxis) {
+					auto const& a = serial.mpm.get_current_state().meshlines[axis];
+					auto const& b = parallel.mpm.get_current_state().meshlines[axis];
+					REQUIRE(a.size() > 40);
+					REQUIRE(a.size() == b.size());
+					for(std::size_t i = 0; i < a.size(); ++i)
+						REQUIRE(a[i]->coord.value() == b[i]->coord.value());
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,133 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <catch2/catch_all.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "lpf.hpp"
+
+#include "domain/mesh/meshline.hpp"
+#include "domain/global.hpp"
+#include "infra/parsers/parser_from_session.hpp"
+#include "infra/serializers/serializer_to_session.hpp"
+
+/// @test expected<void, string> SerializerToSession::run(Board& board, path const& input, path const& output, AnnotationWriter const& write_annotation)
+/// @test expected<Output, string> ParserFromSession::run(path const& session, AnnotationReader const& read_annotation)
+///*****************************************************************************
+
+using namespace domain;
+
+//******************************************************************************
+class StepAnnotation : public IAnnotation {
+public:
+	int const step;
+	explicit StepAnnotation(int step) : step(step) {}
+};
+
+//******************************************************************************
+AxisSpace<std::vector<Coord>> get_meshline_coords(Board const& board) {
+	AxisSpace<std::vector<Coord>> coords;
+	for(auto const& axis : AllAxis)
+		for(auto const& meshline : board.get_meshlines(axis))
+			coords[axis].push_back(meshline->coord);
+	return coords;
+}
+
+//******************************************************************************
+SCENARIO("expected<void, string> SerializerToSession::run(Board& board, path const& input, path const& output, AnnotationWriter const& write_annotation)", "[serializer_to_session]") {
+	auto& caretaker = Caretaker::singleton();
+	auto const session = OEMSH_UNITTEST_DIR "/lpf.oemsh";
+
+	GIVEN("The Lpf complex structure meshed in two remembered steps") {
+		caretaker.reset();
+		std::shared_ptr<Board> lpf = create_lpf();
+		auto params_state = lpf->global_params->get_current_state();
+		params_state.lmin = 1;
+		params_state.proximity_limit = 0;
+		lpf->global_params->set_next_state(params_state);
+		caretaker.remember_current_timepoint();
+
+		caretaker.annotate_current_timepoint(std::make_unique<StepAnnotation>(1));
+		lpf->detect_edges_in_polygons();
+		lpf->detect_colinear_edges();
+		lpf->auto_solve_all_edge_in_polygon();
+		lpf->auto_solve_all_colinear_edges();
+		lpf->detect_individual_edges();
+		lpf->detect_and_solve_too_close_meshline_policies();
+		lpf->detect_intervals();
+		caretaker.remember_current_timepoint();
+		auto const policies_before_mesh = lpf->get_meshline_policies(X).size();
+
+		caretaker.annotate_current_timepoint(std::make_unique<StepAnnotation>(2));
+		lpf->mesh();
+		caretaker.remember_current_timepoint();
+		auto const meshlines = get_meshline_coords(*lpf);
+		REQUIRE_FALSE(meshlines[X].empty());
+
+		WHEN("Saving the session then restoring it") {
+			database_unit = 1e-6;
+			auto const saved = SerializerToSession::run(*lpf, "lpf.csx", session, [](IAnnotation const& annotation, BinaryWriter& out) {
+				out.write(static_cast<StepAnnotation const&>(annotation).step);
+			});
+			database_unit = 0;
+			REQUIRE(saved.has_value());
+
+			lpf.reset();
+			caretaker.reset();
+			auto const restored = ParserFromSession::run(session, [](BinaryReader& in) {
+				int step = 0;
+				in.read(step);
+				return std::make_unique<StepAnnotation>(step);
+			});
+			REQUIRE(restored.has_value());
+			auto const& board = restored->board;
+
+			THEN("Should restore the input, the fixed-point mode and the mesh") {
+				REQUIRE(restored->input == "lpf.csx");
+				REQUIRE(restored->database_unit == 1e-6);
+				REQUIRE(get_meshline_coords(*board) == meshlines);
+				REQUIRE(board->get_polygons(XY).size() == 7);
+			}
+
+			THEN("Should restore annotations") {
+				auto* t = caretaker.find_first_ancestor_with_annotation();
+				REQUIRE(t);
+				REQUIRE(static_cast<StepAnnotation const*>(caretaker.get_annotation(t))->step == 2);
+			}
+
+			THEN("Should undo and redo as before saving") {
+				REQUIRE(caretaker.can_undo());
+				caretaker.undo();
+				REQUIRE(board->get_meshlines(X).empty());
+				REQUIRE(board->get_meshline_policies(X).size() == policies_before_mesh);
+				caretaker.undo();
+				REQUIRE(board->get_meshline_policies(X).empty());
+				caretaker.redo(2);
+				REQUIRE(get_meshline_coords(*board) == meshlines);
+			}
+		}
+	}
+
+	GIVEN("A truncated session") {
+		caretaker.reset();
+		std::shared_ptr<Board> lpf = create_lpf();
+		caretaker.remember_current_timepoint();
+		REQUIRE(SerializerToSession::run(*lpf, "lpf.csx", session, nullptr).has_value());
+		std::filesystem::resize_file(session, std::filesystem::file_size(session) / 2);
+
+		WHEN("Restoring it") {
+			lpf.reset();
+			caretaker.reset();
+			auto const restored = ParserFromSession::run(session, nullptr);
+			THEN("Should fail") {
+				REQUIRE_FALSE(restored.has_value());
+			}
+		}
+	}
+}
@@ -0,0 +1,107 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <ranges>
+#include <vector>
+
+#include "utils/persistent_vector.hpp"
+
+/// @test template<typename T> void PersistentVector<T>::push_back(T value)
+/// @test template<typename T> void PersistentVector<T>::set(std::size_t i, T value)
+/// @test template<typename T> PersistentVector<T>::const_iterator PersistentVector<T>::begin() const noexcept
+///*****************************************************************************
+
+//******************************************************************************
+SCENARIO("template<typename T> void PersistentVector<T>::push_back(T value)", "[utils][persistent_vector]") {
+	GIVEN("An empty PersistentVector") {
+		PersistentVector<std::size_t> a;
+		REQUIRE(a.empty());
+		WHEN("Pushing enough elements to need several levels of nodes") {
+			for(std::size_t i = 0; i < 40000; ++i)
+				a.push_back(i);
+			THEN("Every element should be reachable at its index") {
+				REQUIRE(a.size() == 40000);
+				REQUIRE(a.front() == 0);
+				REQUIRE(a.back() == 39999);
+				for(std::size_t i = 0; i < a.size(); ++i)
+					REQUIRE(a[i] == i);
+			}
+		}
+	}
+
+	GIVEN("A PersistentVector and a copy of it") {
+		PersistentVector<std::size_t> a;
+		for(std::size_t i = 0; i < 1024; ++i)
+			a.push_back(i);
+		auto const b = a;
+		WHEN("Pushing into the original beyond the capacity of its root") {
+			a.push_back(1024);
+			a.push_back(1025);
+			THEN("The copy should be left unchanged") {
+				REQUIRE(a.size() == 1026);
+				REQUIRE(a.back() == 1025);
+				REQUIRE(b.size() == 1024);
+				REQUIRE(b.back() == 1023);
+				REQUIRE(std::ranges::equal(b, std::views::iota(std::size_t(0), std::size_t(1024))));
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("template<typename T> void PersistentVector<T>::set(std::size_t i, T value)", "[utils][persistent_vector]") {
+	GIVEN("A PersistentVector and a copy of it") {
+		PersistentVector<int> a;
+		for(int i = 0; i < 100; ++i)
+			a.push_back(i);
+		auto b = a;
+		WHEN("Replacing an element of the copy") {
+			b.set(42, -1);
+			THEN("Only the copy should see the new value") {
+				REQUIRE(b[42] == -1);
+				REQUIRE(a[42] == 42);
+				REQUIRE(b[41] == 41);
+				REQUIRE(b[43] == 43);
+				REQUIRE_FALSE(a == b);
+			}
+		}
+
+		WHEN("Replacing an element of the original, then restoring it") {
+			a.set(0, 7);
+			a.set(0, 0);
+			THEN("Both should compare equal") {
+				REQUIRE(a == b);
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("template<typename T> PersistentVector<T>::const_iterator PersistentVector<T>::begin() const noexcept", "[utils][persistent_vector]") {
+	GIVEN("A PersistentVector built from a vector") {
+		std::vector<int> v;
+		for(int i = 0; i < 2000; ++i)
+			v.push_back(2000 - i);
+		PersistentVector<int> const a(v);
+		THEN("Iterating should visit the elements in order") {
+			REQUIRE(a.size() == v.size());
+			REQUIRE(std::ranges::equal(a, v));
+			REQUIRE(std::ranges::equal(a | std::views::reverse, v | std::views::reverse));
+		}
+
+		THEN("Iterators should support random access") {
+			REQUIRE(std::ranges::random_access_range<PersistentVector<int>>);
+			auto it = std::ranges::lower_bound(a, 500, std::ranges::greater());
+			REQUIRE(it - a.begin() == 1500);
+			REQUIRE(*it == 500);
+			REQUIRE(it[-1] == 501);
+		}
+	}
+}
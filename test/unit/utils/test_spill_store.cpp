@@ -0,0 +1,93 @@
+///*****************************************************************************
+/// @date Feb 2021
+/// @copyright GPL-3.0-or-later
+/// @author Thomas Lepoix <thomas.lepoix@protonmail.ch>
+///*****************************************************************************
+
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/binary_io.hpp"
+
+#include "utils/spill_store.hpp"
+
+/// @test std::optional<SpillStore::Handle> SpillStore::write(std::span<std::byte const> bytes) noexcept
+/// @test std::optional<std::vector<std::byte>> SpillStore::read(Handle const& handle) const noexcept
+/// @test template<typename T> void BinaryWriter::write(T const& value)
+///*****************************************************************************
+
+//******************************************************************************
+SCENARIO("std::optional<SpillStore::Handle> SpillStore::write(std::span<std::byte const> bytes) noexcept", "[utils][spill_store]") {
+	GIVEN("A SpillStore") {
+		SpillStore store;
+		REQUIRE(store.is_open());
+
+		WHEN("Writing several blocks") {
+			std::vector<std::byte> const a { std::byte(1), std::byte(2), std::byte(3) };
+			std::vector<std::byte> const b(10000, std::byte(42));
+			auto const ha = store.write(a);
+			auto const hb = store.write(b);
+
+			THEN("Each block should be read back as written, in any order") {
+				REQUIRE(ha.has_value());
+				REQUIRE(hb.has_value());
+				REQUIRE(store.size() == a.size() + b.size());
+				REQUIRE(store.read(hb.value()) == b);
+				REQUIRE(store.read(ha.value()) == a);
+			}
+
+			AND_WHEN("Clearing the store") {
+				store.clear();
+
+				THEN("Blocks should not be read back") {
+					REQUIRE_FALSE(store.read(ha.value()).has_value());
+					REQUIRE_FALSE(store.read(hb.value()).has_value());
+				}
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("template<typename T> void BinaryWriter::write(T const& value)", "[utils][spill_store]") {
+	GIVEN("Values of all supported kinds") {
+		int const i = -7;
+		double const d = 0.1;
+		int const* const p = &i;
+		std::string const s = "abc";
+		std::vector<std::pair<int, double>> const v { { 1, 1.5 }, { 2, 2.5 } };
+		std::optional<std::vector<int const*>> const o = std::vector { p, p };
+		std::optional<int> const n;
+
+		WHEN("Writing them then reading them back") {
+			BinaryWriter out;
+			out.write_all(i, d, p, s, v, o, n);
+
+			int ri = 0;
+			double rd = 0;
+			int const* rp = nullptr;
+			std::string rs;
+			std::vector<std::pair<int, double>> rv;
+			std::optional<std::vector<int const*>> ro;
+			std::optional<int> rn = 3;
+			BinaryReader in(out.get_bytes());
+			in.read_all(ri, rd, rp, rs, rv, ro, rn);
+
+			THEN("Should read the same values, pointers as addresses") {
+				REQUIRE(ri == i);
+				REQUIRE(rd == d);
+				REQUIRE(rp == p);
+				REQUIRE(rs == s);
+				REQUIRE(rv == v);
+				REQUIRE(ro == o);
+				REQUIRE_FALSE(rn.has_value());
+				REQUIRE(in.empty());
+			}
+		}
+	}
+}
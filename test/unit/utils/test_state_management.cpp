@@ -8,7 +8,10 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 #include "utils/vector_utils.hpp"
@@ -26,11 +29,13 @@
 /// @test template<typename State> void Originator<State>::erase(std::set<Timepoint*> const& ts) noexcept
 /// @test template<typename State> std::vector<std::tuple<Timepoint*, State>> Originator<State>::get_available_states() const noexcept
 /// @test template<typename State> State const& Originator<State>::get_current_state() const noexcept
+/// @test template<typename State> std::shared_ptr<State const> Originator<State>::share_current_state() const noexcept
 /// @test template<typename State> Timepoint* Originator<State>::next_timepoint() const noexcept
 /// @test template<typename State> void Originator<State>::set_state(Timepoint* t, State const& state) noexcept
 /// @test template<typename State> void Originator<State>::set_next_state(State const& state) noexcept
 /// @test template<typename State> void Originator<State>::set_given_or_next_state(State const& state, Timepoint* t) noexcept
 /// @test template<typename State> std::tuple<Timepoint*, State> Originator<State>::make_next_state() const noexcept
+/// @test template<typename State> std::unique_lock<std::recursive_mutex> Originator<State>::lock() const noexcept
 ///*****************************************************************************
 
 /// Caretaker
@@ -42,7 +47,7 @@
 /// @test void Caretaker::stop_browsing_user_history() noexcept
 /// @test Timepoint* Caretaker::get_history_root() noexcept
 /// @test Timepoint* Caretaker::get_current_timepoint() noexcept
-/// @test vector<Timepoint*> const& Caretaker::get_pinned_timepoints() const noexcept
+/// @test vector<Timepoint*> Caretaker::get_pinned_timepoints() const noexcept
 /// @test Timepoint* Caretaker::make_next_timepoint() noexcept
 /// @test void Caretaker::take_care_of(shared_ptr<IOriginator> const& originator) noexcept
 /// @test void Caretaker::undo(size_t remembered_timepoints) noexcept
@@ -56,6 +61,8 @@
 /// @test bool Caretaker::go_and_remember(Timepoint* t) noexcept
 /// @test bool Caretaker::get_auto_gc() const noexcept
 /// @test void Caretaker::set_auto_gc(bool _auto_gc) noexcept
+/// @test void Caretaker::set_keep_history(bool _keep_history) noexcept
+/// @test void Caretaker::set_spill_threshold(std::size_t remembered_timepoints) noexcept
 /// @test void Caretaker::annotate_current_timepoint(std::unique_ptr<IAnnotation> annotation) noexcept
 /// @test IAnnotation* Caretaker::get_annotation(Timepoint* t) noexcept
 /// @test Timepoint* Caretaker::find_first_ancestor_with_annotation_that(std::function<bool (IAnnotation const*)> const& predicate) noexcept
@@ -68,6 +75,11 @@ struct StateA {
 	int num;
 };
 
+//******************************************************************************
+auto spill_fields(StateA const& state) {
+	return std::tie(state.str, state.num);
+}
+
 //******************************************************************************
 class Annotation : public IAnnotation {
 public:
@@ -179,9 +191,9 @@ SCENARIO("template<typename State> Originator<State>::Originator(Timepoint* init
 			REQUIRE(a.ordered_timepoints.size() == 1);
 			REQUIRE(a.ordered_timepoints[0] == &t);
 
-			REQUIRE(a.states.contains(&t));
-			REQUIRE(a.states.at(&t).str == "ac");
-			REQUIRE(a.states.at(&t).num == 56);
+			REQUIRE(a.find_state(&t));
+			REQUIRE(a.find_state(&t)->str == "ac");
+			REQUIRE(a.find_state(&t)->num == 56);
 		}
 
 		WHEN("Specifying no Caretaker") {
@@ -412,20 +424,20 @@ SCENARIO("template<typename State> void Originator<State>::erase(std::set<Timepo
 				REQUIRE(a.ordered_timepoints[1] == &t1);
 				REQUIRE(a.ordered_timepoints[2] == &t4);
 				REQUIRE(a.ordered_timepoints[3] == &t5);
-				REQUIRE(a.states.contains(&t0));
-				REQUIRE(a.states.contains(&t1));
-				REQUIRE_FALSE(a.states.contains(&t2));
-				REQUIRE_FALSE(a.states.contains(&t3));
-				REQUIRE(a.states.contains(&t4));
-				REQUIRE(a.states.contains(&t5));
-				REQUIRE(a.states.at(&t0).str == "ac");
-				REQUIRE(a.states.at(&t0).num == 56);
-				REQUIRE(a.states.at(&t1).str == "lp");
-				REQUIRE(a.states.at(&t1).num == 8);
-				REQUIRE(a.states.at(&t4).str == "dk");
-				REQUIRE(a.states.at(&t4).num == 12);
-				REQUIRE(a.states.at(&t5).str == "ws");
-				REQUIRE(a.states.at(&t5).num == 6);
+				REQUIRE(a.find_state(&t0));
+				REQUIRE(a.find_state(&t1));
+				REQUIRE_FALSE(a.find_state(&t2));
+				REQUIRE_FALSE(a.find_state(&t3));
+				REQUIRE(a.find_state(&t4));
+				REQUIRE(a.find_state(&t5));
+				REQUIRE(a.find_state(&t0)->str == "ac");
+				REQUIRE(a.find_state(&t0)->num == 56);
+				REQUIRE(a.find_state(&t1)->str == "lp");
+				REQUIRE(a.find_state(&t1)->num == 8);
+				REQUIRE(a.find_state(&t4)->str == "dk");
+				REQUIRE(a.find_state(&t4)->num == 12);
+				REQUIRE(a.find_state(&t5)->str == "ws");
+				REQUIRE(a.find_state(&t5)->num == 6);
 			}
 		}
 
@@ -442,24 +454,24 @@ SCENARIO("template<typename State> void Originator<State>::erase(std::set<Timepo
 				REQUIRE(a.ordered_timepoints[3] == &t3);
 				REQUIRE(a.ordered_timepoints[4] == &t4);
 				REQUIRE(a.ordered_timepoints[5] == &t5);
-				REQUIRE(a.states.contains(&t0));
-				REQUIRE(a.states.contains(&t1));
-				REQUIRE(a.states.contains(&t2));
-				REQUIRE(a.states.contains(&t3));
-				REQUIRE(a.states.contains(&t4));
-				REQUIRE(a.states.contains(&t5));
-				REQUIRE(a.states.at(&t0).str == "ac");
-				REQUIRE(a.states.at(&t0).num == 56);
-				REQUIRE(a.states.at(&t1).str == "lp");
-				REQUIRE(a.states.at(&t1).num == 8);
-				REQUIRE(a.states.at(&t2).str == "gh");
-				REQUIRE(a.states.at(&t2).num == 444);
-				REQUIRE(a.states.at(&t3).str == "lo");
-				REQUIRE(a.states.at(&t3).num == 69);
-				REQUIRE(a.states.at(&t4).str == "dk");
-				REQUIRE(a.states.at(&t4).num == 12);
-				REQUIRE(a.states.at(&t5).str == "ws");
-				REQUIRE(a.states.at(&t5).num == 6);
+				REQUIRE(a.find_state(&t0));
+				REQUIRE(a.find_state(&t1));
+				REQUIRE(a.find_state(&t2));
+				REQUIRE(a.find_state(&t3));
+				REQUIRE(a.find_state(&t4));
+				REQUIRE(a.find_state(&t5));
+				REQUIRE(a.find_state(&t0)->str == "ac");
+				REQUIRE(a.find_state(&t0)->num == 56);
+				REQUIRE(a.find_state(&t1)->str == "lp");
+				REQUIRE(a.find_state(&t1)->num == 8);
+				REQUIRE(a.find_state(&t2)->str == "gh");
+				REQUIRE(a.find_state(&t2)->num == 444);
+				REQUIRE(a.find_state(&t3)->str == "lo");
+				REQUIRE(a.find_state(&t3)->num == 69);
+				REQUIRE(a.find_state(&t4)->str == "dk");
+				REQUIRE(a.find_state(&t4)->num == 12);
+				REQUIRE(a.find_state(&t5)->str == "ws");
+				REQUIRE(a.find_state(&t5)->num == 6);
 			}
 		}
 	}
@@ -541,6 +553,43 @@ SCENARIO("template<typename State> State const& Originator<State>::get_current_s
 				REQUIRE(a.get_current_state().num == 8);
 			}
 		}
+
+		WHEN("Making many states after taking a reference to the current one") {
+			StateA const& init = a.get_current_state();
+			for(int i = 0; i < 100; ++i)
+				a.set_next_state({ .str = "xy", .num = i });
+
+			THEN("The reference should still be valid") {
+				REQUIRE(&init == &a.get_available_states().front().second);
+				REQUIRE(init.str == "ac");
+				REQUIRE(init.num == 56);
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("template<typename State> std::shared_ptr<State const> Originator<State>::share_current_state() const noexcept", "[utils][state_management]") {
+	GIVEN("A Caretaker without history and an Originator") {
+		Caretaker c;
+		c.set_keep_history(false);
+		Originator<StateA const> a(c.get_history_root(), { .str = "ac", .num = 56 }, c);
+
+		WHEN("Replacing the state in place after sharing it") {
+			std::shared_ptr<StateA const> const shared = a.share_current_state();
+			a.set_next_state({ .str = "lp", .num = 8 });
+
+			THEN("The snapshot should hold the replaced state") {
+				REQUIRE(shared->str == "ac");
+				REQUIRE(shared->num == 56);
+			}
+
+			THEN("A new snapshot should hold the new state") {
+				REQUIRE(a.share_current_state()->str == "lp");
+				REQUIRE(a.share_current_state()->num == 8);
+				REQUIRE(a.share_current_state().get() == &a.get_current_state());
+			}
+		}
 	}
 }
 
@@ -588,12 +637,12 @@ SCENARIO("template<typename State> void Originator<State>::set_state(Timepoint*
 			b.set_state(&t1, { .str = "lp", .num = 8 });
 
 			THEN("The new state should be registered to the given Timepoint") {
-				REQUIRE(a.states.contains(&t1));
-				REQUIRE(a.states.at(&t1).str == "lp");
-				REQUIRE(a.states.at(&t1).num == 8);
-				REQUIRE(b.states.contains(&t1));
-				REQUIRE(b.states.at(&t1).str == "lp");
-				REQUIRE(b.states.at(&t1).num == 8);
+				REQUIRE(a.find_state(&t1));
+				REQUIRE(a.find_state(&t1)->str == "lp");
+				REQUIRE(a.find_state(&t1)->num == 8);
+				REQUIRE(b.find_state(&t1));
+				REQUIRE(b.find_state(&t1)->str == "lp");
+				REQUIRE(b.find_state(&t1)->num == 8);
 			}
 
 			THEN("The given Timepoint should be appended to timepoints order tracking") {
@@ -621,17 +670,17 @@ SCENARIO("template<typename State> void Originator<State>::set_state(Timepoint*
 
 				AND_WHEN("State type is not const") {
 					THEN("The new state should be registered to the given Timepoint") {
-						REQUIRE(a.states.contains(&t0));
-						REQUIRE(a.states.at(&t0).str == "gh");
-						REQUIRE(a.states.at(&t0).num == 444);
+						REQUIRE(a.find_state(&t0));
+						REQUIRE(a.find_state(&t0)->str == "gh");
+						REQUIRE(a.find_state(&t0)->num == 444);
 					}
 				}
 
 				AND_WHEN("State type is const") {
 					THEN("The new state should not be registered to the given Timepoint") {
-						REQUIRE(b.states.contains(&t0));
-						REQUIRE(b.states.at(&t0).str == "ac");
-						REQUIRE(b.states.at(&t0).num == 56);
+						REQUIRE(b.find_state(&t0));
+						REQUIRE(b.find_state(&t0)->str == "ac");
+						REQUIRE(b.find_state(&t0)->num == 56);
 					}
 				}
 
@@ -655,6 +704,31 @@ SCENARIO("template<typename State> void Originator<State>::set_state(Timepoint*
 				}
 			}
 		}
+
+		WHEN("Setting states at Timepoints out of their creation order") {
+			Timepoint t1;
+			Timepoint t2;
+			Timepoint t3;
+			a.set_state(&t3, { .str = "c", .num = 3 });
+			a.set_state(&t1, { .str = "a", .num = 1 });
+			a.set_state(&t2, { .str = "b", .num = 2 });
+
+			THEN("Each state should be registered to its Timepoint") {
+				REQUIRE(a.find_state(&t0)->num == 56);
+				REQUIRE(a.find_state(&t1)->num == 1);
+				REQUIRE(a.find_state(&t2)->num == 2);
+				REQUIRE(a.find_state(&t3)->num == 3);
+				REQUIRE(std::ranges::is_sorted(a.states, {}, [](auto const& entry) { return entry.id; }));
+			}
+
+			THEN("Timepoints order tracking should keep the insertion order") {
+				REQUIRE(a.ordered_timepoints.size() == 4);
+				REQUIRE(a.ordered_timepoints[1] == &t3);
+				REQUIRE(a.ordered_timepoints[2] == &t1);
+				REQUIRE(a.ordered_timepoints[3] == &t2);
+				REQUIRE(a.get_current_timepoint() == &t2);
+			}
+		}
 	}
 }
 
@@ -673,9 +747,9 @@ SCENARIO("template<typename State> void Originator<State>::set_next_state(State
 				REQUIRE(t1->parent() == t0);
 
 				AND_THEN("The new state should be registered to this new Timepoint") {
-					REQUIRE(a.states.contains(t1));
-					REQUIRE(a.states.at(t1).str == "lp");
-					REQUIRE(a.states.at(t1).num == 8);
+					REQUIRE(a.find_state(t1));
+					REQUIRE(a.find_state(t1)->str == "lp");
+					REQUIRE(a.find_state(t1)->num == 8);
 				}
 
 				AND_THEN("Caretaker current timepoint should be updated to this new Timepoint") {
@@ -701,9 +775,9 @@ SCENARIO("template<typename State> void Originator<State>::set_given_or_next_sta
 				REQUIRE(t1->parent() == t0);
 
 				AND_THEN("The new state should be registered to this new Timepoint") {
-					REQUIRE(a.states.contains(t1));
-					REQUIRE(a.states.at(t1).str == "lp");
-					REQUIRE(a.states.at(t1).num == 8);
+					REQUIRE(a.find_state(t1));
+					REQUIRE(a.find_state(t1)->str == "lp");
+					REQUIRE(a.find_state(t1)->num == 8);
 				}
 
 				AND_THEN("Caretaker current timepoint should be updated to this new Timepoint") {
@@ -721,9 +795,9 @@ SCENARIO("template<typename State> void Originator<State>::set_given_or_next_sta
 				REQUIRE(t1 == &n);
 
 				AND_THEN("The new state should be registered to this given Timepoint") {
-					REQUIRE(a.states.contains(t1));
-					REQUIRE(a.states.at(t1).str == "lp");
-					REQUIRE(a.states.at(t1).num == 8);
+					REQUIRE(a.find_state(t1));
+					REQUIRE(a.find_state(t1)->str == "lp");
+					REQUIRE(a.find_state(t1)->num == 8);
 				}
 
 				AND_THEN("Caretaker current timepoint should not be updated to this given Timepoint") {
@@ -870,26 +944,26 @@ SCENARIO("void Caretaker::reset() noexcept", "[utils][state_management]") {
 		REQUIRE(contains_expired(c.originators));
 
 		REQUIRE(x->states.size() == 3);
-		REQUIRE(x->states[a].str == "ac");
-		REQUIRE(x->states[a].num == 56);
-		REQUIRE(x->states[d2].str == "lo");
-		REQUIRE(x->states[d2].num == 69);
-		REQUIRE(x->states[e2].str == "lo");
-		REQUIRE(x->states[e2].num == 68);
+		REQUIRE(x->find_state(a)->str == "ac");
+		REQUIRE(x->find_state(a)->num == 56);
+		REQUIRE(x->find_state(d2)->str == "lo");
+		REQUIRE(x->find_state(d2)->num == 69);
+		REQUIRE(x->find_state(e2)->str == "lo");
+		REQUIRE(x->find_state(e2)->num == 68);
 
 		REQUIRE(y->states.size() == 6);
-		REQUIRE(y->states[a].str == "lp");
-		REQUIRE(y->states[a].num == 8);
-		REQUIRE(y->states[c1].str == "dk");
-		REQUIRE(y->states[c1].num == 12);
-		REQUIRE(y->states[d3].str == "dk");
-		REQUIRE(y->states[d3].num == 13);
-		REQUIRE(y->states[f1].str == "dk");
-		REQUIRE(y->states[f1].num == 14);
-		REQUIRE(y->states[d4].str == "dk");
-		REQUIRE(y->states[d4].num == 15);
-		REQUIRE(y->states[g1].str == "dk");
-		REQUIRE(y->states[g1].num == 16);
+		REQUIRE(y->find_state(a)->str == "lp");
+		REQUIRE(y->find_state(a)->num == 8);
+		REQUIRE(y->find_state(c1)->str == "dk");
+		REQUIRE(y->find_state(c1)->num == 12);
+		REQUIRE(y->find_state(d3)->str == "dk");
+		REQUIRE(y->find_state(d3)->num == 13);
+		REQUIRE(y->find_state(f1)->str == "dk");
+		REQUIRE(y->find_state(f1)->num == 14);
+		REQUIRE(y->find_state(d4)->str == "dk");
+		REQUIRE(y->find_state(d4)->num == 15);
+		REQUIRE(y->find_state(g1)->str == "dk");
+		REQUIRE(y->find_state(g1)->num == 16);
 
 		WHEN("Running") {
 			c.reset();
@@ -1000,50 +1074,59 @@ SCENARIO("void Caretaker::garbage_collector() noexcept", "[utils][state_manageme
 		REQUIRE(contains_expired(c.originators));
 
 		REQUIRE(x->states.size() == 3);
-		REQUIRE(x->states[a].str == "ac");
-		REQUIRE(x->states[a].num == 56);
-		REQUIRE(x->states[d2].str == "lo");
-		REQUIRE(x->states[d2].num == 69);
-		REQUIRE(x->states[e2].str == "lo");
-		REQUIRE(x->states[e2].num == 68);
+		REQUIRE(x->find_state(a)->str == "ac");
+		REQUIRE(x->find_state(a)->num == 56);
+		REQUIRE(x->find_state(d2)->str == "lo");
+		REQUIRE(x->find_state(d2)->num == 69);
+		REQUIRE(x->find_state(e2)->str == "lo");
+		REQUIRE(x->find_state(e2)->num == 68);
 
 		REQUIRE(y->states.size() == 6);
-		REQUIRE(y->states[a].str == "lp");
-		REQUIRE(y->states[a].num == 8);
-		REQUIRE(y->states[c1].str == "dk");
-		REQUIRE(y->states[c1].num == 12);
-		REQUIRE(y->states[d3].str == "dk");
-		REQUIRE(y->states[d3].num == 13);
-		REQUIRE(y->states[f1].str == "dk");
-		REQUIRE(y->states[f1].num == 14);
-		REQUIRE(y->states[d4].str == "dk");
-		REQUIRE(y->states[d4].num == 15);
-		REQUIRE(y->states[g1].str == "dk");
-		REQUIRE(y->states[g1].num == 16);
+		REQUIRE(y->find_state(a)->str == "lp");
+		REQUIRE(y->find_state(a)->num == 8);
+		REQUIRE(y->find_state(c1)->str == "dk");
+		REQUIRE(y->find_state(c1)->num == 12);
+		REQUIRE(y->find_state(d3)->str == "dk");
+		REQUIRE(y->find_state(d3)->num == 13);
+		REQUIRE(y->find_state(f1)->str == "dk");
+		REQUIRE(y->find_state(f1)->num == 14);
+		REQUIRE(y->find_state(d4)->str == "dk");
+		REQUIRE(y->find_state(d4)->num == 15);
+		REQUIRE(y->find_state(g1)->str == "dk");
+		REQUIRE(y->find_state(g1)->num == 16);
 
 		WHEN("Running") {
 			c.garbage_collector();
 
+			THEN("Originators should keep their states until they are used") {
+				REQUIRE(x->states.size() == 3);
+				REQUIRE(y->states.size() == 6);
+			}
+
 			THEN("Should erase Originator states that does not correspond to Timepoints located between the history root and either the current timepoint, any pinned or remembered timepoint") {
+				x->get_current_timepoint();
+				y->get_current_timepoint();
+
 				REQUIRE(x->states.size() == 2);
-				REQUIRE(x->states[a].str == "ac");
-				REQUIRE(x->states[a].num == 56);
-				REQUIRE(x->states[d2].str == "lo");
-				REQUIRE(x->states[d2].num == 69);
+				REQUIRE(x->ordered_timepoints.size() == 2);
+				REQUIRE(x->find_state(a)->str == "ac");
+				REQUIRE(x->find_state(a)->num == 56);
+				REQUIRE(x->find_state(d2)->str == "lo");
+				REQUIRE(x->find_state(d2)->num == 69);
 
 				REQUIRE(y->states.size() == 6);
-				REQUIRE(y->states[a].str == "lp");
-				REQUIRE(y->states[a].num == 8);
-				REQUIRE(y->states[c1].str == "dk");
-				REQUIRE(y->states[c1].num == 12);
-				REQUIRE(y->states[d3].str == "dk");
-				REQUIRE(y->states[d3].num == 13);
-				REQUIRE(y->states[f1].str == "dk");
-				REQUIRE(y->states[f1].num == 14);
-				REQUIRE(y->states[d4].str == "dk");
-				REQUIRE(y->states[d4].num == 15);
-				REQUIRE(y->states[g1].str == "dk");
-				REQUIRE(y->states[g1].num == 16);
+				REQUIRE(y->find_state(a)->str == "lp");
+				REQUIRE(y->find_state(a)->num == 8);
+				REQUIRE(y->find_state(c1)->str == "dk");
+				REQUIRE(y->find_state(c1)->num == 12);
+				REQUIRE(y->find_state(d3)->str == "dk");
+				REQUIRE(y->find_state(d3)->num == 13);
+				REQUIRE(y->find_state(f1)->str == "dk");
+				REQUIRE(y->find_state(f1)->num == 14);
+				REQUIRE(y->find_state(d4)->str == "dk");
+				REQUIRE(y->find_state(d4)->num == 15);
+				REQUIRE(y->find_state(g1)->str == "dk");
+				REQUIRE(y->find_state(g1)->num == 16);
 			}
 
 			THEN("Should erase Timepoints that are not located between the history root and either the current timepoint, any pinned or remembered timepoint; even if annotated") {
@@ -1207,7 +1290,7 @@ SCENARIO("Timepoint* Caretaker::get_current_timepoint() noexcept", "[utils][stat
 }
 
 //******************************************************************************
-SCENARIO("vector<Timepoint*> const& Caretaker::get_pinned_timepoints() const noexcept", "[utils][state_management]") {
+SCENARIO("vector<Timepoint*> Caretaker::get_pinned_timepoints() const noexcept", "[utils][state_management]") {
 	GIVEN("A Caretaker with some pinned timepoints") {
 		Caretaker c;
 		[[maybe_unused]] Timepoint* t0 = c.get_current_timepoint();
@@ -2128,6 +2211,113 @@ SCENARIO("void Caretaker::set_auto_gc(bool _auto_gc) noexcept", "[utils][state_m
 	}
 }
 
+//******************************************************************************
+SCENARIO("void Caretaker::set_keep_history(bool _keep_history) noexcept", "[utils][state_management]") {
+	GIVEN("A Caretaker without history and an Originator") {
+		Caretaker c;
+		c.set_keep_history(false);
+		Timepoint* root = c.get_history_root();
+		auto x = std::make_shared<Originator<StateA const>>(root, StateA { .str = "ac", .num = 56 }, c);
+		c.take_care_of(x);
+
+		THEN("The Originator should not be registered") {
+			REQUIRE(c.originators.empty());
+		}
+
+		WHEN("Making several next states") {
+			for(int i = 0; i < 10; ++i) {
+				auto [t, state] = x->make_next_state();
+				state.num = i;
+				x->set_state(t, state);
+			}
+
+			THEN("No Timepoint should be allocated") {
+				REQUIRE(c.make_next_timepoint() == root);
+				REQUIRE(c.get_current_timepoint() == root);
+				REQUIRE(root->is_leaf());
+			}
+
+			THEN("The Originator should only keep the last state, in place of the initial one") {
+				REQUIRE(x->states.size() == 1);
+				REQUIRE(x->ordered_timepoints.size() == 1);
+				REQUIRE(x->get_current_timepoint() == root);
+				REQUIRE(x->get_current_state().str == "ac");
+				REQUIRE(x->get_current_state().num == 9);
+			}
+
+			AND_WHEN("Running the garbage collector") {
+				c.garbage_collector();
+
+				THEN("Nothing should be collected") {
+					REQUIRE(c.get_gc_generation() == 0);
+					REQUIRE(x->get_current_state().num == 9);
+				}
+			}
+		}
+
+		WHEN("Annotating the current timepoint twice") {
+			c.annotate_current_timepoint(std::make_unique<Annotation>(1));
+			c.annotate_current_timepoint(std::make_unique<Annotation>(2));
+
+			THEN("The last annotation should be kept") {
+				REQUIRE(c.annotations.size() == 1);
+				REQUIRE(static_cast<Annotation*>(c.get_annotation(root))->value == 2);
+				REQUIRE(c.find_first_ancestor_with_annotation(true) == root);
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("void Caretaker::set_spill_threshold(std::size_t remembered_timepoints) noexcept", "[utils][state_management]") {
+	GIVEN("A Caretaker spilling all but the last remembered Timepoint and an Originator") {
+		Caretaker c;
+		c.set_spill_threshold(1);
+		REQUIRE(c.get_spill_threshold() == 1);
+		auto x = std::make_shared<Originator<StateA const>>(c.get_history_root(), StateA { .str = "ac", .num = 0 }, c);
+		c.take_care_of(x);
+
+		WHEN("Making and remembering several states") {
+			std::vector<Timepoint*> ts { c.get_history_root() };
+			for(int i = 1; i < 4; ++i) {
+				x->set_next_state({ .str = std::string(i, 'x'), .num = i });
+				c.remember_current_timepoint();
+				ts.push_back(x->get_current_timepoint());
+			}
+
+			THEN("Only the current state should stay resident") {
+				REQUIRE(x->states.size() == 4);
+				for(std::size_t i = 0; i < 3; ++i) {
+					REQUIRE(x->states[i].state == nullptr);
+					REQUIRE(x->states[i].spilled.has_value());
+				}
+				REQUIRE(x->states[3].state != nullptr);
+				REQUIRE(x->get_current_state().num == 3);
+			}
+
+			AND_WHEN("Undoing that far") {
+				c.undo(2);
+
+				THEN("The old state should be read back") {
+					REQUIRE(x->get_current_timepoint() == ts[1]);
+					REQUIRE(x->get_current_state().str == "x");
+					REQUIRE(x->get_current_state().num == 1);
+					REQUIRE(x->states[1].state != nullptr);
+				}
+
+				THEN("All states should be available") {
+					auto const states = x->get_available_states();
+					REQUIRE(states.size() == 4);
+					for(int i = 0; i < 4; ++i) {
+						REQUIRE(states[i].first == ts[i]);
+						REQUIRE(states[i].second.num == i);
+					}
+				}
+			}
+		}
+	}
+}
+
 //******************************************************************************
 SCENARIO("void Caretaker::annotate_current_timepoint(std::unique_ptr<IAnnotation> annotation) noexcept", "[utils][state_management]") {
 	GIVEN("A Caretaker") {
@@ -2336,6 +2526,66 @@ SCENARIO("Timepoint* Caretaker::find_first_ancestor_with_annotation() noexcept",
 	}
 }
 
+//******************************************************************************
+SCENARIO("template<typename State> std::unique_lock<std::recursive_mutex> Originator<State>::lock() const noexcept", "[utils][state_management]") {
+	GIVEN("An Originator shared between several threads, each also owning its own Originator") {
+		Caretaker& c = Caretaker::singleton();
+		Timepoint* t0 = c.get_current_timepoint();
+
+		std::size_t const nthreads = 4;
+		std::size_t const nstates = 100;
+		auto shared = std::make_shared<Originator<std::vector<std::size_t>>>(t0);
+		c.take_care_of(shared);
+		std::vector<std::shared_ptr<Originator<StateA>>> owned;
+		for(std::size_t i = 0; i < nthreads; ++i) {
+			owned.push_back(std::make_shared<Originator<StateA>>(t0, StateA { .str = "", .num = 0 }));
+			c.take_care_of(owned.back());
+		}
+
+		WHEN("Each thread makes states of its own Originator and read-modify-writes the shared one while holding its lock") {
+			std::vector<std::thread> threads;
+			for(std::size_t i = 0; i < nthreads; ++i)
+				threads.emplace_back([&, i] {
+					for(std::size_t j = 0; j < nstates; ++j) {
+						auto state = owned[i]->get_current_state();
+						++state.num;
+						owned[i]->set_next_state(state);
+
+						auto const guard = shared->lock();
+						auto [t, values] = shared->make_next_state();
+						values.push_back(i);
+						shared->set_state(t, values);
+					}
+				});
+			for(auto& thread : threads)
+				thread.join();
+
+			THEN("No update of the shared Originator should be lost") {
+				REQUIRE(shared->get_current_state().size() == nthreads * nstates);
+				for(std::size_t i = 0; i < nthreads; ++i)
+					REQUIRE(std::ranges::count(shared->get_current_state(), i) == nstates);
+			}
+
+			THEN("Each owned Originator should hold all its states") {
+				for(auto const& originator : owned) {
+					REQUIRE(originator->get_current_state().num == nstates);
+					REQUIRE(originator->get_available_states().size() == nstates + 1);
+				}
+			}
+
+			THEN("All timepoints should be unique and form a single chain") {
+				auto const descendants = t0->cluster(false);
+				REQUIRE(descendants.size() == 2 * nthreads * nstates);
+				REQUIRE(t0->leafs() == std::vector<Timepoint*>({ c.get_current_timepoint() }));
+				std::set<std::size_t> ids;
+				for(auto const* t : descendants)
+					ids.insert(t->id);
+				REQUIRE(ids.size() == descendants.size());
+			}
+		}
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 //******************************************************************************
@@ -9,6 +9,8 @@
 //#include <memory>
 //#include <iostream>
 #include <algorithm>
+#include <cstddef>
+#include <set>
 
 #include "utils/vector_utils.hpp"
 
@@ -18,12 +20,17 @@
 /// @test bool operator==(TreeNode const& b) const
 /// @test TreeNode* TreeNode::parent() const
 /// @test TreeNode* TreeNode::root()
+/// @test std::ranges::subrange<TreeNode::UpIterator, std::default_sentinel_t> TreeNode::up(bool include_itself)
+/// @test std::ranges::subrange<TreeNode::ChildIterator, std::default_sentinel_t> TreeNode::children() const
+/// @test std::ranges::subrange<TreeNode::DescendantIterator, std::default_sentinel_t> TreeNode::descendants(bool include_itself)
 /// @test std::vector<TreeNode*> TreeNode::ancestors(bool include_itself)
+/// @test TreeNode* TreeNode::ancestor(std::size_t n) const
 /// @test std::vector<TreeNode*> TreeNode::leafs(bool include_itself)
 /// @test std::vector<TreeNode*> TreeNode::cluster(bool include_itself)
 /// @test bool TreeNode::is_descendant_of(TreeNode const& node) const
 /// @test bool TreeNode::is_ancestor_of(TreeNode const& node) const
 /// @test void TreeNode::erase_from_descendants(std::set<TreeNode*> const& nodes)
+/// @test template<typename K, typename E> void TreeNode::prune(K const& is_kept, E const& on_erase)
 /// @test TreeNode* TreeNode::common_ancestor(TreeNode& node, bool include_themselves)
 /// @test TreeNode* common_ancestor(TreeNode& a, TreeNode& b, bool include_themselves) @todo
 /// @test bool TreeNode::is_root() const
@@ -41,8 +48,8 @@ SCENARIO("TreeNode& TreeNode::add_child()", "[utils][tree_node]") {
 			TreeNode& b = a.add_child();
 
 			THEN("Another TreeNode must be added in children and has parent correctly set") {
-				REQUIRE(a.children.size() == 1);
-				REQUIRE(&b == &a.children.back());
+				REQUIRE(ranges::distance(a.children()) == 1);
+				REQUIRE(&b == *a.children().begin());
 				REQUIRE(&a == b.parent());
 			}
 		}
@@ -120,6 +127,146 @@ SCENARIO("TreeNode* TreeNode::root()", "[utils][tree_node]") {
 	}
 }
 
+//******************************************************************************
+SCENARIO("std::ranges::subrange<TreeNode::UpIterator, std::default_sentinel_t> TreeNode::up(bool include_itself)", "[utils][tree_node]") {
+	GIVEN("A multilevel tree of TreeNodes") {
+		// + a
+		//   + b
+		//     + c1
+		//     | + d1 <---
+		//     + c2
+
+		[[maybe_unused]] TreeNode a;
+		[[maybe_unused]] TreeNode& b = a.add_child();
+		[[maybe_unused]] TreeNode& c1 = b.add_child();
+		[[maybe_unused]] TreeNode& c2 = b.add_child();
+		[[maybe_unused]] TreeNode& d1 = c1.add_child();
+
+		WHEN("Going up from a leaf") {
+			THEN("Should visit the same TreeNodes as ancestors(), in the same order") {
+				REQUIRE(ranges::equal(d1.up(), d1.ancestors()));
+				REQUIRE(ranges::equal(d1.up(true), d1.ancestors(true)));
+			}
+		}
+
+		WHEN("Going up from the root") {
+			THEN("Should only visit the root itself if included") {
+				REQUIRE(ranges::empty(a.up()));
+				REQUIRE(ranges::distance(a.up(true)) == 1);
+				REQUIRE(*a.up(true).begin() == &a);
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("std::ranges::subrange<TreeNode::ChildIterator, std::default_sentinel_t> TreeNode::children() const", "[utils][tree_node]") {
+	GIVEN("A TreeNode with several children") {
+		TreeNode a;
+		TreeNode& b1 = a.add_child();
+		TreeNode& b2 = a.add_child();
+		TreeNode& b3 = a.add_child();
+		b2.add_child();
+
+		THEN("Should visit its children only, in insertion order") {
+			REQUIRE(ranges::equal(a.children(), vector<TreeNode*> { &b1, &b2, &b3 }));
+			REQUIRE(ranges::empty(b1.children()));
+		}
+
+		WHEN("Erasing the middle child") {
+			a.erase_from_descendants({ &b2 });
+
+			THEN("Its siblings should stay linked") {
+				REQUIRE(ranges::equal(a.children(), vector<TreeNode*> { &b1, &b3 }));
+			}
+
+			AND_WHEN("Adding a new child") {
+				TreeNode& b4 = a.add_child();
+
+				THEN("It should come last") {
+					REQUIRE(ranges::equal(a.children(), vector<TreeNode*> { &b1, &b3, &b4 }));
+				}
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("std::ranges::subrange<TreeNode::DescendantIterator, std::default_sentinel_t> TreeNode::descendants(bool include_itself)", "[utils][tree_node]") {
+	GIVEN("A multilevel tree of TreeNodes") {
+		// + a
+		//   + b
+		//     + c1 <---
+		//     | + d1
+		//     | + d2
+		//     | | + e1
+		//     | + d3
+		//     + c2
+
+		[[maybe_unused]] TreeNode a;
+		[[maybe_unused]] TreeNode& b = a.add_child();
+		[[maybe_unused]] TreeNode& c1 = b.add_child();
+		[[maybe_unused]] TreeNode& c2 = b.add_child();
+		[[maybe_unused]] TreeNode& d1 = c1.add_child();
+		[[maybe_unused]] TreeNode& d2 = c1.add_child();
+		[[maybe_unused]] TreeNode& d3 = c1.add_child();
+		[[maybe_unused]] TreeNode& e1 = d2.add_child();
+
+		THEN("Should visit the subtree in preorder, without leaving it") {
+			REQUIRE(ranges::equal(c1.descendants(), vector<TreeNode*> { &d1, &d2, &e1, &d3 }));
+			REQUIRE(ranges::equal(c1.descendants(true), vector<TreeNode*> { &c1, &d1, &d2, &e1, &d3 }));
+			REQUIRE(ranges::equal(a.descendants(), vector<TreeNode*> { &b, &c1, &d1, &d2, &e1, &d3, &c2 }));
+		}
+
+		THEN("Should visit nothing below a leaf") {
+			REQUIRE(ranges::empty(c2.descendants()));
+			REQUIRE(ranges::equal(c2.descendants(true), vector<TreeNode*> { &c2 }));
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("TreeNode* TreeNode::ancestor(std::size_t n) const", "[utils][tree_node]") {
+	GIVEN("A chain of TreeNodes deeper than a few powers of two") {
+		TreeNode root;
+		vector<TreeNode*> chain { &root };
+		for(size_t i = 0; i < 100; ++i)
+			chain.push_back(&chain.back()->add_child());
+
+		THEN("depth should count ancestors") {
+			for(size_t i = 0; i < chain.size(); ++i)
+				REQUIRE(chain[i]->depth == i);
+		}
+
+		THEN("Should return the n-th ancestor, or nullptr above the root") {
+			for(size_t i = 0; i < chain.size(); ++i) {
+				for(size_t n = 0; n <= i; ++n)
+					REQUIRE(chain[i]->ancestor(n) == chain[i - n]);
+				REQUIRE(chain[i]->ancestor(i + 1) == nullptr);
+			}
+		}
+
+		AND_GIVEN("Branches forking from every TreeNode of the chain") {
+			vector<TreeNode*> forks;
+			for(auto* node : chain) {
+				TreeNode* it = &node->add_child();
+				for(size_t i = 0; i < node->depth % 7; ++i)
+					it = &it->add_child();
+				forks.push_back(it);
+			}
+
+			THEN("common_ancestor() should return the forking TreeNode") {
+				for(size_t i = 0; i < chain.size(); ++i) {
+					REQUIRE(forks[i]->common_ancestor(*chain.back()) == chain[i]);
+					REQUIRE(chain.back()->common_ancestor(*forks[i]) == chain[i]);
+					for(size_t j = i + 1; j < chain.size(); ++j)
+						REQUIRE(forks[i]->common_ancestor(*forks[j]) == chain[i]);
+				}
+			}
+		}
+	}
+}
+
 //******************************************************************************
 SCENARIO("std::vector<TreeNode*> TreeNode::ancestors(bool include_itself)", "[utils][tree_node]") {
 	GIVEN("A multilevel tree of TreeNodes") {
@@ -424,22 +571,22 @@ SCENARIO("void TreeNode::erase_from_descendants(std::set<TreeNode*> const& nodes
 		[[maybe_unused]] TreeNode x;
 		[[maybe_unused]] TreeNode& y = x.add_child();
 
-		auto const contains = [](std::list<TreeNode> const& list, TreeNode const& node) {
-			return std::ranges::find(list, node) != std::end(list);
+		auto const contains = [](auto const& children, TreeNode& node) {
+			return std::ranges::find(children, &node) != std::end(children);
 		};
 
 		AND_GIVEN("A TreeNode in the middle of the tree") {
 			WHEN("Trying to erase itself") {
 				THEN("Should fail") {
 					c1.erase_from_descendants({ &c1 });
-					REQUIRE(contains(b.children, c1));
+					REQUIRE(contains(b.children(), c1));
 				}
 			}
 
 			WHEN("Trying to erase a TreeNode that is above itself") {
 				THEN("Should fail") {
 					c1.erase_from_descendants({ &b });
-					REQUIRE(contains(a.children, b));
+					REQUIRE(contains(a.children(), b));
 				}
 			}
 
@@ -447,34 +594,91 @@ SCENARIO("void TreeNode::erase_from_descendants(std::set<TreeNode*> const& nodes
 				THEN("Should success") {
 					c1.erase_from_descendants({ &d1 });
 					c1.erase_from_descendants({ &e1 });
-					REQUIRE_FALSE(contains(c1.children, d1));
-					REQUIRE_FALSE(contains(d2.children, e1));
+					REQUIRE_FALSE(contains(c1.children(), d1));
+					REQUIRE_FALSE(contains(d2.children(), e1));
 				}
 			}
 
 			WHEN("Trying to erase a TreeNode that is somewhere else in the tree") {
 				THEN("Should fail") {
 					c1.erase_from_descendants({ &c2 });
-					REQUIRE(contains(b.children, c2));
+					REQUIRE(contains(b.children(), c2));
 				}
 			}
 
 			WHEN("Trying to erase a TreeNode that is not part of the tree") {
 				THEN("Should fail") {
 					c1.erase_from_descendants({ &y });
-					REQUIRE(contains(x.children, y));
+					REQUIRE(contains(x.children(), y));
 				}
 			}
 
 			WHEN("Trying to erase all the cases above at once") {
 				THEN("Should erase the erasable TreeNodes") {
 					c1.erase_from_descendants({ &c1, &b, &d1, &e1, &c2, &y });
-					REQUIRE(contains(b.children, c1));
-					REQUIRE(contains(a.children, b));
-					REQUIRE_FALSE(contains(c1.children, d1));
-					REQUIRE_FALSE(contains(d2.children, e1));
-					REQUIRE(contains(b.children, c2));
-					REQUIRE(contains(x.children, y));
+					REQUIRE(contains(b.children(), c1));
+					REQUIRE(contains(a.children(), b));
+					REQUIRE_FALSE(contains(c1.children(), d1));
+					REQUIRE_FALSE(contains(d2.children(), e1));
+					REQUIRE(contains(b.children(), c2));
+					REQUIRE(contains(x.children(), y));
+				}
+			}
+		}
+	}
+}
+
+//******************************************************************************
+SCENARIO("template<typename K, typename E> void TreeNode::prune(K const& is_kept, E const& on_erase)", "[utils][tree_node]") {
+	GIVEN("A multilevel tree of TreeNodes") {
+		// + a
+		//   + b
+		//     + c1 <--- kept
+		//     | + d1
+		//     | + d2 <- kept
+		//     | | + e1
+		//     + c2
+		//       + ... deep chain
+
+		[[maybe_unused]] TreeNode a;
+		[[maybe_unused]] TreeNode& b = a.add_child();
+		[[maybe_unused]] TreeNode& c1 = b.add_child();
+		[[maybe_unused]] TreeNode& c2 = b.add_child();
+		[[maybe_unused]] TreeNode& d1 = c1.add_child();
+		[[maybe_unused]] TreeNode& d2 = c1.add_child();
+		[[maybe_unused]] TreeNode& e1 = d2.add_child();
+
+		std::size_t const chain_length = 100000;
+		TreeNode* it = &c2;
+		for(std::size_t i = 0; i < chain_length; ++i)
+			it = &it->add_child();
+
+		std::set<TreeNode const*> const kept { &a, &b, &c1, &d2 };
+
+		WHEN("Pruning TreeNodes that are not kept") {
+			std::size_t erased = 0;
+			bool has_erased_kept = false;
+			std::set<TreeNode const*> erased_addresses;
+			a.prune(
+				[&](TreeNode const& node) { return kept.contains(&node); },
+				[&](TreeNode const& node) { ++erased; has_erased_kept |= kept.contains(&node); erased_addresses.insert(&node); });
+
+			THEN("Should erase them and all their descendants, even along a deep chain") {
+				REQUIRE(erased == 3 + chain_length);
+				REQUIRE_FALSE(has_erased_kept);
+				REQUIRE(a.cluster(true).size() == 4);
+				REQUIRE(contains(a.cluster(true), &d2));
+				REQUIRE(d2.is_leaf());
+			}
+
+			AND_WHEN("Growing the tree again") {
+				TreeNode* x = &d2.add_child();
+
+				THEN("Should reuse the memory of erased TreeNodes") {
+					REQUIRE(erased_addresses.contains(x));
+					REQUIRE(x->parent() == &d2);
+					REQUIRE(x->depth == 4);
+					REQUIRE(a.cluster(true).size() == 5);
 				}
 			}
 		}